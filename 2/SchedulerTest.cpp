@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "src/load_kernels.h"
+#include "src/scheduling.h"
+
+// Работа, перенесенная последним ходом: единственная, чей процессор отличается от before
+static int movedJob(const SchedulingSolution &solution, const std::vector<int> &before)
+{
+    int moved = -1;
+    for (int job = 0; job < solution.getNumJobs(); ++job)
+    {
+        if (solution.getJobProcessor(job) != before[job])
+        {
+            EXPECT_EQ(moved, -1);
+            moved = job;
+        }
+    }
+    return moved;
+}
+
+TEST(TargetedMoveTest, RollbackDoesNotRepeatProposal)
+{
+    // Три работы длительности 4 на загруженном процессоре: ближайшая к половине разрыва длительность - 4
+    std::vector<uint8_t> durations = {4, 4, 4, 1};
+    SchedulingSolution solution(4, 2, durations, {0, 0, 0, 0});
+    SchedulingMutation mutation({MoveKind::Targeted});
+    Xoshiro256 rng(1);
+    std::vector<int> before = solution.getAssignment();
+
+    mutation.mutate(solution, rng);
+    int first = movedJob(solution, before);
+    solution.rollback();
+    ASSERT_EQ(solution.getAssignment(), before);
+
+    mutation.mutate(solution, rng);
+    int second = movedJob(solution, before);
+    ASSERT_GE(first, 0);
+    ASSERT_GE(second, 0);
+    EXPECT_EQ(durations[first], 4);
+    EXPECT_EQ(durations[second], 4);
+    EXPECT_NE(first, second);
+}
+
+// Уровни ядер, доступные процессору, на котором идет тест
+static std::vector<SimdLevel> supportedLevels()
+{
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+    SimdLevel best = detectSimdLevel();
+    if (best == SimdLevel::Avx2 || best == SimdLevel::Avx512)
+    {
+        levels.push_back(SimdLevel::Avx2);
+    }
+    if (best == SimdLevel::Avx512)
+    {
+        levels.push_back(SimdLevel::Avx512);
+    }
+    return levels;
+}
+
+TEST(LoadKernelsTest, VectorKernelsMatchScalar)
+{
+    LoadKernels scalar = makeLoadKernels(SimdLevel::Scalar);
+    Xoshiro256 rng(7);
+    for (SimdLevel level : supportedLevels())
+    {
+        LoadKernels kernels = makeLoadKernels(level);
+        ASSERT_EQ(kernels.level, level);
+        // Размеры вокруг ширины векторов и их кратных, в том числе не кратные 4, 8 и 16
+        for (int count = 1; count <= 70; ++count)
+        {
+            for (int trial = 0; trial < 20; ++trial)
+            {
+                SCOPED_TRACE(std::string(simdLevelName(level)) + " count " + std::to_string(count));
+                // Малый диапазон значений дает много равных нагрузок и проверяет выбор первого индекса
+                long long spread = trial % 2 ? 4 : 1000000;
+                std::vector<long long> first(count);
+                std::vector<long long> second(count);
+                for (int i = 0; i < count; ++i)
+                {
+                    first[i] = static_cast<long long>(rng.uniformInt(static_cast<int>(spread))) - spread / 2;
+                    second[i] = static_cast<long long>(rng.uniformInt(static_cast<int>(spread))) - spread / 2;
+                }
+                LoadRange expected = scalar.loadRange(first.data(), count);
+                LoadRange actual = kernels.loadRange(first.data(), count);
+                EXPECT_EQ(actual.minIndex, expected.minIndex);
+                EXPECT_EQ(actual.maxIndex, expected.maxIndex);
+                EXPECT_EQ(kernels.argMinOfMax(first.data(), second.data(), count), scalar.argMinOfMax(first.data(), second.data(), count));
+            }
+        }
+
+        for (int numJobs : {0, 1, 7, 8, 9, 15, 16, 17, 1000, 4097})
+        {
+            for (int numProcessors : {1, 3, 8, 40})
+            {
+                SCOPED_TRACE(std::string(simdLevelName(level)) + " jobs " + std::to_string(numJobs) + " processors " + std::to_string(numProcessors));
+                std::vector<int> assignment(numJobs);
+                std::vector<uint8_t> durations(numJobs);
+                for (int i = 0; i < numJobs; ++i)
+                {
+                    // Половина работ подряд на одном процессоре: повторяющиеся адреса в пределах вектора
+                    assignment[i] = i % 2 ? rng.uniformInt(numProcessors) : 0;
+                    durations[i] = static_cast<uint8_t>(rng.uniformInt(256));
+                }
+                std::vector<long long> expected(numProcessors, 5);
+                std::vector<long long> actual(numProcessors, 5);
+                scalar.accumulateLoads(assignment.data(), durations.data(), numJobs, numProcessors, expected.data());
+                kernels.accumulateLoads(assignment.data(), durations.data(), numJobs, numProcessors, actual.data());
+                EXPECT_EQ(actual, expected);
+            }
+        }
+    }
+}
@@ -15,43 +15,58 @@ def generate_csv_output(num_jobs, min_duration, max_duration, output_file="jobs.
             writer.writerow([f"Job_{job_id}", duration])
     print(f"CSV data generated with {num_jobs} jobs and saved to {output_file}")
 
+def convert_to_binary(csv_file="jobs.csv", output_file="jobs.bin"):
+    """
+    Конвертирует CSV файл работ в бинарный формат, чтобы прогоны не разбирали текст заново.
+    """
+    subprocess.run(["./convert_jobs.o", csv_file, output_file], check=True, capture_output=True)
+    return output_file
+
 def run_simulation(filename, num_processors, cooling_method):
     """
     Запускает C++ программу с заданными параметрами и возвращает финальную стоимость и время выполнения.
     """
     total_cost = 0
     total_time = 0
+    total_rate = 0
     num_runs = 5
+    # Прогон i использует зерно i + 1: повтор скрипта воспроизводит те же цепочки
+    seeds = list(range(1, num_runs + 1))
 
-    for _ in range(num_runs):
+    for seed in seeds:
         start_time = time.time()
         result = subprocess.run(
-            ["./main_solo.o", filename, str(num_processors), cooling_method],
+            ["./main_solo.o", filename, str(num_processors), cooling_method, "--seed", str(seed)],
             capture_output=True,
             text=True
         )
         end_time = time.time()
 
-        # Найти строку с "Best solution found with cost:" и получить значение стоимости
+        # Найти строку с "Best solution found with cost:" и получить значение стоимости,
+        # а также пропускную способность цикла отжига из строки "iterations per second:"
         output_lines = result.stdout.splitlines()
         final_cost = None
+        iterations_per_second = 0
         for line in output_lines:
             if "Best solution found with cost:" in line:
                 final_cost = float(line.split(":")[-1].strip())
-                break
+            elif "iterations per second:" in line:
+                iterations_per_second = float(line.split(":")[-1].strip())
 
         # Если стоимость не найдена, вернем None и сообщение об ошибке
         if final_cost is None:
             print(f"Error in program output: {result.stdout}")
-            return None, None
+            return None, None, None, None
 
         total_cost += final_cost
         total_time += (end_time - start_time)
+        total_rate += iterations_per_second
 
     average_cost = total_cost / num_runs
     average_time = total_time / num_runs
+    average_rate = total_rate / num_runs
 
-    return average_cost, average_time
+    return average_cost, average_time, average_rate, " ".join(map(str, seeds))
 
 def main():
     # Параметры для тестирования
@@ -64,20 +79,21 @@ def main():
     # Открываем файл для записи результатов
     with open("results.csv", mode="w", newline="") as results_file:
         writer = csv.writer(results_file)
-        writer.writerow(["num_jobs", "num_processors", "cooling_method", "final_cost", "execution_time"])
+        writer.writerow(["num_jobs", "num_processors", "cooling_method", "final_cost", "execution_time", "iterations_per_second", "seeds"])
 
         # Запускаем программу с различными параметрами
         for num_jobs in num_jobs_list:
             # Генерация файла CSV для текущего значения num_jobs
             generate_csv_output(num_jobs, min_duration, max_duration)
+            jobs_file = convert_to_binary()
 
             for num_processors in num_processors_list:
                 for cooling_method in cooling_methods:
                     print(f"Running with {num_jobs} jobs, {num_processors} processors, and {cooling_method} cooling")
-                    average_cost, average_time = run_simulation("jobs.csv", num_processors, cooling_method)
+                    average_cost, average_time, average_rate, seeds = run_simulation(jobs_file, num_processors, cooling_method)
                     if average_cost is not None:
-                        writer.writerow([num_jobs, num_processors, cooling_method, average_cost, average_time])
-                        print(f"Result: Jobs = {num_jobs}, Processors = {num_processors}, Cooling = {cooling_method}, Average Cost = {average_cost}, Average Time = {average_time:.2f} seconds")
+                        writer.writerow([num_jobs, num_processors, cooling_method, average_cost, average_time, average_rate, seeds])
+                        print(f"Result: Jobs = {num_jobs}, Processors = {num_processors}, Cooling = {cooling_method}, Average Cost = {average_cost}, Average Time = {average_time:.2f} seconds, Iterations/s = {average_rate:.0f}")
                     else:
                         print("Error in simulation, skipping result")
 
@@ -4,12 +4,13 @@ import csv
 import re
 
 # Функция для запуска программы с параметром и получения результата
-def run_main_mult(num_proc):
+def run_main_mult(num_proc, seed):
     try:
         start_time = time.time()  # Начало замера времени
-        # Запуск программы с параметром num_proc
+        # Запуск программы с параметром num_proc и фиксированным главным зерном.
+        # Потоки закрепляются за ядрами, чтобы решения островов размещались в памяти узлов NUMA своих ядер
         result = subprocess.run(
-            ['./main_mult.o', str(num_proc)],
+            ['./main_mult.o', str(num_proc), '--seed', str(seed), '--pin', 'cores'],
             stdout=subprocess.PIPE,
             stderr=subprocess.PIPE,
             text=True
@@ -26,35 +27,45 @@ def run_main_mult(num_proc):
             print(final_cost, num_proc)
         else:
             final_cost = None
+
+        # Пропускная способность отжига по всем островам
+        match = re.search(r'iterations per second: ([0-9.e+]+)', result.stdout)
+        iterations_per_second = float(match.group(1)) if match else None
         
-        return exec_time, final_cost
+        return exec_time, final_cost, iterations_per_second
     except Exception as e:
         print(f"Ошибка при выполнении: {e}")
-        return None, None
+        return None, None, None
 
 # Запись результатов в CSV
 def write_to_csv(filename, data):
     with open(filename, mode='w', newline='') as file:
         writer = csv.writer(file)
         # Запись заголовков
-        writer.writerow(["num_proc", "avg_exec_time", "avg_final_cost"])
+        writer.writerow(["num_proc", "avg_exec_time", "avg_final_cost", "avg_iterations_per_second", "scaling_efficiency", "seeds"])
         # Запись данных
         writer.writerows(data)
 
 # Основной блок программы
 def main():
     data = []
+    # Пропускная способность одного потока - база для эффективности масштабирования
+    single_thread_rate = None
     # Запуск тестирования 5 раз для каждого значения num_proc
-    for num_proc in range(2, 15, 2):
+    for num_proc in [1] + list(range(2, 15, 2)):
         exec_times = []
         final_costs = []
+        rates = []
         
-        # Запуск программы 5 раз для получения среднего значения
-        for _ in range(5):
-            exec_time, final_cost = run_main_mult(num_proc)
+        # Запуск программы 5 раз для получения среднего значения; прогон i использует зерно i + 1
+        seeds = list(range(1, 6))
+        for seed in seeds:
+            exec_time, final_cost, rate = run_main_mult(num_proc, seed)
             if exec_time is not None and final_cost is not None:
                 exec_times.append(exec_time)
                 final_costs.append(final_cost)
+            if rate is not None:
+                rates.append(rate)
 
         # Рассчитываем среднее время выполнения и итоговую стоимость
         if exec_times and final_costs:
@@ -65,8 +76,14 @@ def main():
             avg_exec_time = None
             avg_final_cost = None
 
+        # Эффективность масштабирования: доля от идеального роста итераций в секунду
+        avg_rate = sum(rates) / len(rates) if rates else None
+        if num_proc == 1:
+            single_thread_rate = avg_rate
+        efficiency = avg_rate / (num_proc * single_thread_rate) if avg_rate and single_thread_rate else None
+
         # Добавляем результат в таблицу данных
-        data.append([num_proc, avg_exec_time, avg_final_cost])
+        data.append([num_proc, avg_exec_time, avg_final_cost, avg_rate, efficiency, " ".join(map(str, seeds))])
 
     # Запись всех результатов в CSV файл
     write_to_csv("results_mult.csv", data)
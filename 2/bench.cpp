@@ -0,0 +1,282 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+#include "src/annealing.h"
+#include "src/scheduling.h"
+#include "src/options.h"
+#include "src/simulated_annealing.h"
+#include "src/island_model.h"
+
+// Встроенный бенчмарк решателей. В отличие от auto_test.py, экземпляры генерируются в памяти,
+// а время измеряется внутри процесса только для самого отжига: без генерации CSV, запуска процесса
+// и разбора файла. Сетка параметров: работы x процессоры x закон охлаждения x потоки.
+// Один поток - последовательный отжиг (main_solo), несколько - островная модель (main_mult).
+// Повтор r использует зерно deriveSeed(seed, r) во всех конфигурациях, поэтому конфигурации
+// сравниваются на одинаковых случайных начальных решениях. Целевые функции (--objective) тоже входят
+// в сетку; для сравнения критериев между собой каждая строка содержит все три критерия итогового решения
+
+// Список целых через запятую
+std::vector<int> parseIntList(const std::string &text)
+{
+    std::vector<int> values;
+    size_t begin = 0;
+    while (begin <= text.size())
+    {
+        size_t end = std::min(text.find(',', begin), text.size());
+        values.push_back(std::stoi(text.substr(begin, end - begin)));
+        begin = end + 1;
+    }
+    return values;
+}
+
+// Список строк через запятую
+std::vector<std::string> parseStringList(const std::string &text)
+{
+    std::vector<std::string> values;
+    size_t begin = 0;
+    while (begin <= text.size())
+    {
+        size_t end = std::min(text.find(',', begin), text.size());
+        values.push_back(text.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return values;
+}
+
+// Полуширина 95% доверительного интервала среднего по t-распределению Стьюдента
+double confidenceHalfWidth(const std::vector<double> &values)
+{
+    static const double quantiles[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    size_t n = values.size();
+    if (n < 2)
+    {
+        return 0.0;
+    }
+    double mean = 0;
+    for (double value : values)
+    {
+        mean += value;
+    }
+    mean /= n;
+    double variance = 0;
+    for (double value : values)
+    {
+        variance += (value - mean) * (value - mean);
+    }
+    variance /= n - 1;
+    double t = n - 1 <= 30 ? quantiles[n - 2] : 1.96;
+    return t * std::sqrt(variance / n);
+}
+
+double mean(const std::vector<double> &values)
+{
+    double sum = 0;
+    for (double value : values)
+    {
+        sum += value;
+    }
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+double median(std::vector<double> values)
+{
+    if (values.empty())
+    {
+        return -1;
+    }
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+// Итог одного прогона
+struct RunResult
+{
+    double cost;
+    double seconds;
+    long long iterations;
+    double timeToTarget; // -1, если целевая стоимость не достигнута
+    double imbalance;
+    double makespan;
+    double variance;
+};
+
+int main(int argc, char *argv[])
+{
+    CommandLine commandLine;
+    try
+    {
+        commandLine = CommandLine(argc, argv, {"jobs", "processors", "cooling", "threads", "objective", "repeats", "seed", "target", "init", "moves", "time-limit", "output", "exchange"});
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (!commandLine.positional().empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [--jobs 256000,...] [--processors 640,...] [--cooling boltzmann,cauchy,logarithmic] [--threads 1,...] [--objective imbalance,makespan,variance,...]"
+                  << " [--repeats N] [--seed S] [--target cost] [--init random|lpt|kk] [--moves adaptive|...] [--time-limit seconds] [--exchange async|rounds] [--output file]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        // По умолчанию - та же сетка, что у auto_test.py
+        std::vector<int> jobCounts = parseIntList(commandLine.get("jobs", "256000,128000,64000,32000,16000"));
+        std::vector<int> processorCounts = parseIntList(commandLine.get("processors", "640,320,160,80,40"));
+        std::vector<std::string> coolingMethods = parseStringList(commandLine.get("cooling", "boltzmann,cauchy,logarithmic"));
+        std::vector<int> threadCounts = parseIntList(commandLine.get("threads", "1"));
+        std::vector<std::string> objectiveSpecs = parseStringList(commandLine.get("objective", "imbalance"));
+        int repeats = std::stoi(commandLine.get("repeats", "5"));
+        if (repeats < 1)
+        {
+            throw std::invalid_argument("Number of repeats must be positive");
+        }
+        uint64_t seed = std::stoull(commandLine.get("seed", "1"));
+        double targetCost = std::stod(commandLine.get("target", "1"));
+        std::string initMethod = commandLine.get("init", "random");
+        SchedulingMutation mutationPrototype(parseMoveKinds(commandLine.get("moves", "adaptive")));
+        bool timeLimited = commandLine.has("time-limit");
+        double timeLimit = std::stod(commandLine.get("time-limit", "0"));
+        std::string outputFile = commandLine.get("output", "bench_results.csv");
+        // Обмен островной модели: rounds делает итоговую стоимость воспроизводимой при том же --seed
+        std::string exchangeMode = commandLine.get("exchange", "async");
+        if (exchangeMode != "async" && exchangeMode != "rounds")
+        {
+            throw std::invalid_argument("Invalid exchange mode '" + exchangeMode + "'. Available modes: async, rounds");
+        }
+
+        double initialTemperature = 100.0;
+        int maxIterations = 100000;
+        int maxNoImprovementCount = 100;
+
+        std::ofstream output(outputFile);
+        if (!output)
+        {
+            throw std::runtime_error("Cannot open output file: " + outputFile);
+        }
+        // Имена первых столбцов совпадают с results.csv, поэтому gen_heat.py читает и этот файл
+        output << "num_jobs,num_processors,cooling_method,threads,objective,runs,final_cost,final_cost_ci95,final_cost_min,final_cost_max,"
+               << "execution_time,execution_time_ci95,iterations_per_second,target_cost,target_reached,time_to_target,"
+               << "final_imbalance,final_makespan,final_variance,seed,exchange" << std::endl;
+
+        for (int numJobs : jobCounts)
+        {
+            // Экземпляр: длительности 1..100, как в gen_tasks.py, от зерна, зависящего только от числа работ
+            Xoshiro256 instanceRng(deriveSeed(seed, 0x10000000ULL + numJobs));
+            std::vector<uint8_t> jobDurations(numJobs);
+            for (uint8_t &duration : jobDurations)
+            {
+                duration = static_cast<uint8_t>(1 + instanceRng.uniformInt(100));
+            }
+
+            for (int numProcessors : processorCounts)
+            {
+                for (const std::string &coolingMethod : coolingMethods)
+                {
+                    std::unique_ptr<CoolingSchedule> coolingSchedule = makeCoolingSchedule(coolingMethod, initialTemperature);
+                    if (!coolingSchedule)
+                    {
+                        throw std::invalid_argument("Invalid cooling method '" + coolingMethod + "'. Available methods: boltzmann, cauchy, logarithmic");
+                    }
+                    for (const std::string &objectiveSpec : objectiveSpecs)
+                    {
+                        SchedulingObjective objective = parseObjective(objectiveSpec);
+                        for (int numThreads : threadCounts)
+                        {
+                            std::vector<RunResult> runs;
+                            for (int r = 0; r < repeats; ++r)
+                            {
+                                uint64_t runSeed = deriveSeed(seed, r);
+                                Xoshiro256 rng(deriveSeed(runSeed, 0));
+                                auto solution = std::make_shared<SchedulingSolution>(numJobs, numProcessors, jobDurations, buildInitialAssignment(initMethod, jobDurations, numProcessors, rng), objective);
+                                auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeLimit));
+
+                                RunResult run;
+                                visitCoolingSchedule(*coolingSchedule, [&](const auto &cooling)
+                                                     {
+                                    if (numThreads == 1)
+                                    {
+                                        SchedulingMutation mutation = mutationPrototype;
+                                        SimulatedAnnealing sa(solution.get(), &mutation, &cooling, initialTemperature, maxIterations, maxNoImprovementCount, rng);
+                                        sa.setTargetCost(targetCost);
+                                        if (timeLimited)
+                                        {
+                                            sa.setDeadline(deadline);
+                                        }
+                                        sa.run();
+                                        run = {sa.getBestCost(), sa.getSeconds(), sa.getIterations(), sa.getTimeToTarget(),
+                                               solution->getImbalance(), solution->getMakespan(), solution->getLoadVariance()};
+                                    }
+                                    else
+                                    {
+                                        IslandModelOptions options;
+                                        options.numThreads = numThreads;
+                                        options.initialTemperature = initialTemperature;
+                                        options.maxNoImprovementCount = maxNoImprovementCount;
+                                        options.masterSeed = runSeed;
+                                        options.targetCost = targetCost;
+                                        options.timeLimited = timeLimited;
+                                        options.deadline = deadline;
+                                        options.synchronousRounds = exchangeMode == "rounds";
+                                        IslandModelResult result = runIslandModel(solution, mutationPrototype, cooling, options);
+                                        const auto &best = static_cast<const SchedulingSolution &>(*result.bestSolution);
+                                        run = {result.bestCost, result.seconds, result.iterations, result.timeToTarget,
+                                               best.getImbalance(), best.getMakespan(), best.getLoadVariance()};
+                                    } });
+                                runs.push_back(run);
+                            }
+
+                            std::vector<double> costs;
+                            std::vector<double> times;
+                            std::vector<double> targetTimes;
+                            std::vector<double> imbalances;
+                            std::vector<double> makespans;
+                            std::vector<double> variances;
+                            long long iterations = 0;
+                            double seconds = 0;
+                            for (const RunResult &run : runs)
+                            {
+                                costs.push_back(run.cost);
+                                times.push_back(run.seconds);
+                                if (run.timeToTarget >= 0)
+                                {
+                                    targetTimes.push_back(run.timeToTarget);
+                                }
+                                imbalances.push_back(run.imbalance);
+                                makespans.push_back(run.makespan);
+                                variances.push_back(run.variance);
+                                iterations += run.iterations;
+                                seconds += run.seconds;
+                            }
+                            double rate = seconds > 0 ? iterations / seconds : 0;
+                            output << numJobs << "," << numProcessors << "," << coolingMethod << "," << numThreads << "," << objective.describe() << "," << runs.size() << ","
+                                   << mean(costs) << "," << confidenceHalfWidth(costs) << "," << *std::min_element(costs.begin(), costs.end()) << "," << *std::max_element(costs.begin(), costs.end()) << ","
+                                   << mean(times) << "," << confidenceHalfWidth(times) << "," << rate << ","
+                                   << targetCost << "," << targetTimes.size() << "," << median(targetTimes) << ","
+                                   << mean(imbalances) << "," << mean(makespans) << "," << mean(variances) << "," << seed << "," << exchangeMode << std::endl;
+                            std::cout << "Jobs = " << numJobs << ", Processors = " << numProcessors << ", Cooling = " << coolingMethod << ", Threads = " << numThreads << ", Objective = " << objective.describe()
+                                      << ": cost " << mean(costs) << " +- " << confidenceHalfWidth(costs) << ", time " << mean(times) << " s, iterations/s " << rate
+                                      << ", target reached " << targetTimes.size() << "/" << runs.size() << " (median " << median(targetTimes) << " s)" << std::endl;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,3 @@
+#! /bin/bash
+g++ main_batch.cpp --std=c++23 -O2 -o main_batch.o
+./main_batch.o batch.txt
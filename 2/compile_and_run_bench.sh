@@ -0,0 +1,3 @@
+#! /bin/bash
+g++ bench.cpp --std=c++23 -O2 -o bench.o
+./bench.o --repeats 5 --output bench_results.csv
\ No newline at end of file
@@ -0,0 +1,3 @@
+#! /bin/bash
+g++ convert_jobs.cpp --std=c++23 -O2 -o convert_jobs.o
+./convert_jobs.o jobs.csv jobs.bin
\ No newline at end of file
@@ -0,0 +1,3 @@
+#! /bin/bash
+g++ gen_jobs.cpp --std=c++23 -O2 -o gen_jobs.o
+./gen_jobs.o 10000000 jobs.bin --distribution zipf --seed 1
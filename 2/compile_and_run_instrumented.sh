@@ -0,0 +1,3 @@
+#! /bin/bash
+g++ main_solo.cpp --std=c++23 -O2 -DANNEALING_INSTRUMENTATION -o main_solo_instrumented.o
+./main_solo_instrumented.o jobs.csv 40 logarithmic 2> instrumentation.json
\ No newline at end of file
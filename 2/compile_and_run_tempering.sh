@@ -0,0 +1,3 @@
+#! /bin/bash
+g++ main_tempering.cpp --std=c++23 -O2 -o main_tempering.o
+./main_tempering.o jobs.csv 40 logarithmic 8 4
\ No newline at end of file
@@ -0,0 +1,3 @@
+#! /bin/bash
+g++ SchedulerTest.cpp --std=c++23 -O2 -o scheduler_test.o -lgtest -lgtest_main -pthread
+./scheduler_test.o
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include <iostream>
+#include <vector>
+
+#include "src/job_loader.h"
+
+// Конвертер CSV файла работ "Job ID,Duration" в бинарный формат JOBSBIN1
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <input.csv> <output.bin>" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::vector<uint8_t> jobDurations = loadJobDurationsFromCSV(argv[1]);
+        saveJobDurationsToBinary(argv[2], jobDurations);
+        std::cout << "Converted " << jobDurations.size() << " jobs to " << argv[2] << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
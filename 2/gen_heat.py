@@ -1,3 +1,4 @@
+import sys
 import pandas as pd
 import seaborn as sns
 import matplotlib.pyplot as plt
@@ -47,5 +48,5 @@ def generate_heatmaps(file_path="results.csv"):
         plt.close()
         print(f"Heatmap for {method} cooling method saved as {method}_cooling_heatmap_final_cost.png")
 
-# Запуск функции для генерации картинок
-generate_heatmaps("results.csv")
+# Запуск функции для генерации картинок; можно передать результаты бенчмарка (bench_results.csv)
+generate_heatmaps(sys.argv[1] if len(sys.argv) > 1 else "results.csv")
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "src/job_generator.h"
+#include "src/job_loader.h"
+#include "src/options.h"
+
+// Генератор экземпляров задачи: замена gen_tasks.py для больших экземпляров (10M-100M работ).
+// Длительности генерируются параллельно блоками по jobBlockSize работ, и каждый блок сразу пишется
+// в CSV "Job ID,Duration" или в бинарный формат JOBSBIN1, так что память не зависит от числа работ.
+// Формат выбирается флагом --format, по умолчанию - по расширению выходного файла (.bin - бинарный)
+int main(int argc, char *argv[])
+{
+    CommandLine commandLine;
+    try
+    {
+        commandLine = CommandLine(argc, argv, {"distribution", "min", "max", "shape", "correlation", "seed", "threads", "format"});
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (commandLine.positional().size() != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <num_jobs> <output_file> [--distribution uniform|zipf|bimodal|pareto] [--min 1] [--max 100]"
+                  << " [--shape value] [--correlation probability] [--seed S] [--threads N] [--format csv|bin]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        size_t numJobs = std::stoull(commandLine.positional()[0]);
+        std::string outputFile = commandLine.positional()[1];
+        std::string distributionName = commandLine.get("distribution", "uniform");
+        int minDuration = std::stoi(commandLine.get("min", "1"));
+        int maxDuration = std::stoi(commandLine.get("max", "100"));
+        double shape = std::stod(commandLine.get("shape", "-1"));
+        double correlation = std::stod(commandLine.get("correlation", "0"));
+        uint64_t seed = std::stoull(commandLine.get("seed", "1"));
+        int numThreads = std::stoi(commandLine.get("threads", "0"));
+        bool binaryByExtension = outputFile.size() >= 4 && outputFile.compare(outputFile.size() - 4, 4, ".bin") == 0;
+        std::string format = commandLine.get("format", binaryByExtension ? "bin" : "csv");
+        if (format != "csv" && format != "bin")
+        {
+            throw std::invalid_argument("Invalid format '" + format + "'. Available formats: csv, bin");
+        }
+        if (correlation < 0 || correlation >= 1)
+        {
+            throw std::invalid_argument("Correlation must be in [0, 1)");
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        DurationDistribution distribution = makeDurationDistribution(distributionName, minDuration, maxDuration, shape);
+        numThreads = generatorThreads(numThreads, numJobs);
+        if (format == "bin")
+        {
+            JobFileWriter writer(outputFile);
+            streamJobDurations(numJobs, distribution, seed, correlation, numThreads,
+                               [](int, size_t, const uint8_t *, size_t) {},
+                               [&](int, size_t, const uint8_t *durations, size_t count)
+                               { writer.write(durations, count); });
+            writer.finish();
+        }
+        else
+        {
+            std::ofstream file(outputFile, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                throw std::runtime_error("Unable to open file " + outputFile);
+            }
+            file << "Job ID,Duration\n";
+            // Строки блока форматируются в том же потоке, что его сгенерировал
+            std::vector<std::string> texts(numThreads);
+            streamJobDurations(numJobs, distribution, seed, correlation, numThreads,
+                               [&](int t, size_t firstJob, const uint8_t *durations, size_t count)
+                               { formatCsvRows(durations, firstJob, count, texts[t]); },
+                               [&](int t, size_t, const uint8_t *, size_t)
+                               { file.write(texts[t].data(), texts[t].size()); });
+            if (!file.flush())
+            {
+                throw std::runtime_error("Unable to write file " + outputFile);
+            }
+        }
+        double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Generated " << numJobs << " jobs (" << distributionName << ", seed " << seed << ") to " << outputFile
+                  << " in " << totalSeconds << " s" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+
+#include "src/annealing.h"
+#include "src/scheduling.h"
+#include "src/job_loader.h"
+#include "src/options.h"
+#include "src/thread_pool.h"
+#include "src/simulated_annealing.h"
+
+// Пакетный режим: один процесс решает поток экземпляров на общем пуле потоков.
+// Экземпляры читаются из файла-манифеста или из stdin ("-") строками
+//   <filename> <num_processors> <cooling_method> [time_limit]
+// (пустые строки и строки, начинающиеся с '#', пропускаются) и ставятся в пул сразу после чтения,
+// поэтому stdin может быть бесконечным потоком заданий. Каждый экземпляр решается последовательным
+// отжигом на одном потоке пула; бюджет времени отсчитывается от начала решения, а не от постановки
+// в очередь. Результаты печатаются строками CSV по мере завершения, в порядке готовности.
+// Файл работ разбирается один раз и разделяется всеми экземплярами, которые на него ссылаются
+
+// Кэш загруженных файлов работ. Первый запросивший поток загружает файл, остальные ждут его future
+class JobFileCache
+{
+public:
+    std::shared_ptr<const std::vector<uint8_t>> get(const std::string &filename)
+    {
+        std::promise<std::shared_ptr<const std::vector<uint8_t>>> promise;
+        std::shared_future<std::shared_ptr<const std::vector<uint8_t>>> future;
+        bool loader = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = files.find(filename);
+            if (it == files.end())
+            {
+                future = promise.get_future().share();
+                files.emplace(filename, future);
+                loader = true;
+            }
+            else
+            {
+                future = it->second;
+            }
+        }
+        if (loader)
+        {
+            try
+            {
+                promise.set_value(std::make_shared<const std::vector<uint8_t>>(loadJobDurations(filename)));
+            }
+            catch (...)
+            {
+                promise.set_exception(std::current_exception());
+            }
+        }
+        return future.get();
+    }
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::shared_future<std::shared_ptr<const std::vector<uint8_t>>>> files;
+};
+
+// Одна строка манифеста
+struct BatchInstance
+{
+    int index;               // Номер экземпляра в манифесте, от 0
+    std::string filename;
+    int numProcessors;
+    std::string coolingMethod;
+    bool timeLimited;
+    double timeLimit;
+};
+
+// Разбор строки манифеста; timeLimit по умолчанию берется из --time-limit
+BatchInstance parseBatchLine(const std::string &line, int index, bool defaultTimeLimited, double defaultTimeLimit)
+{
+    std::istringstream fields(line);
+    BatchInstance instance{index, "", 0, "", defaultTimeLimited, defaultTimeLimit};
+    std::string processors;
+    std::string timeLimit;
+    std::string extra;
+    if (!(fields >> instance.filename >> processors >> instance.coolingMethod))
+    {
+        throw std::invalid_argument("expected '<filename> <num_processors> <cooling_method> [time_limit]'");
+    }
+    instance.numProcessors = std::stoi(processors);
+    if (instance.numProcessors < 1)
+    {
+        throw std::invalid_argument("number of processors must be positive");
+    }
+    if (fields >> timeLimit)
+    {
+        instance.timeLimited = true;
+        instance.timeLimit = std::stod(timeLimit);
+    }
+    if (fields >> extra)
+    {
+        throw std::invalid_argument("unexpected field '" + extra + "'");
+    }
+    return instance;
+}
+
+int main(int argc, char *argv[])
+{
+    CommandLine commandLine;
+    try
+    {
+        commandLine = CommandLine(argc, argv, {"threads", "init", "moves", "objective", "time-limit", "seed", "output", "pin"});
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (commandLine.positional().size() > 1)
+    {
+        std::cerr << "Usage: " << argv[0] << " [manifest|-] [--threads N] [--init random|lpt|kk] [--moves adaptive|move,swap,kexchange,targeted,batch] [--objective spec]"
+                  << " [--time-limit seconds] [--seed S] [--pin none|cores] [--output file|-]" << std::endl;
+        std::cerr << "Manifest lines: <filename> <num_processors> <cooling_method> [time_limit]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::string manifest = commandLine.positional().empty() ? "-" : commandLine.positional()[0];
+        int numThreads = std::stoi(commandLine.get("threads", std::to_string(std::max(1u, std::thread::hardware_concurrency()))));
+        std::string initMethod = commandLine.get("init", "random");
+        SchedulingMutation mutationPrototype(parseMoveKinds(commandLine.get("moves", "adaptive")));
+        SchedulingObjective objective = parseObjective(commandLine.get("objective", "imbalance"));
+        bool defaultTimeLimited = commandLine.has("time-limit");
+        double defaultTimeLimit = std::stod(commandLine.get("time-limit", "0"));
+        // Без --seed зерно случайное; экземпляр i всегда получает deriveSeed(masterSeed, i).
+        // Это зерно попадает в столбец seed: main_solo с ним повторяет решение экземпляра без срока
+        uint64_t masterSeed = commandLine.has("seed") ? std::stoull(commandLine.get("seed", "0")) : randomMasterSeed();
+        if (numThreads < 1)
+        {
+            throw std::invalid_argument("Number of threads must be positive");
+        }
+        // cores - потоки закрепляются за ядрами из маски процесса (taskset); по умолчанию не закрепляются
+        std::string pinMode = commandLine.get("pin", "none");
+        if (pinMode != "none" && pinMode != "cores")
+        {
+            throw std::invalid_argument("Invalid pin mode '" + pinMode + "'. Available modes: none, cores");
+        }
+
+        std::ifstream manifestFile;
+        std::istream *input = &std::cin;
+        if (manifest != "-")
+        {
+            manifestFile.open(manifest);
+            if (!manifestFile)
+            {
+                throw std::runtime_error("Cannot open manifest file: " + manifest);
+            }
+            input = &manifestFile;
+        }
+        std::ofstream outputFile;
+        std::ostream *output = &std::cout;
+        if (commandLine.get("output", "-") != "-")
+        {
+            outputFile.open(commandLine.get("output", "-"));
+            if (!outputFile)
+            {
+                throw std::runtime_error("Cannot open output file: " + commandLine.get("output", "-"));
+            }
+            output = &outputFile;
+        }
+
+        double initialTemperature = 100.0;
+        int maxIterations = 100000;
+        int maxNoImprovementCount = 100;
+
+        std::mutex outputMutex;
+        *output << "index,filename,num_processors,cooling_method,num_jobs,initial_cost,final_cost,iterations,execution_time,seed,status" << std::endl;
+        // Строка результата; ошибка экземпляра не останавливает пакет и попадает в столбец status
+        auto writeResult = [&](const BatchInstance &instance, int numJobs, double initialCost, double finalCost, long long iterations, double seconds, const std::string &status)
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            *output << instance.index << "," << instance.filename << "," << instance.numProcessors << "," << instance.coolingMethod << ","
+                    << numJobs << "," << initialCost << "," << finalCost << "," << iterations << "," << seconds << "," << deriveSeed(masterSeed, instance.index) << "," << status << std::endl;
+        };
+
+        JobFileCache cache;
+        ThreadPool pool(numThreads, pinMode == "cores");
+        if (!pool.getPinningError().empty())
+        {
+            std::cerr << "Warning: " << pool.getPinningError() << std::endl;
+        }
+        auto batchStart = std::chrono::steady_clock::now();
+        int numInstances = 0;
+        int numErrors = 0;
+        std::string line;
+        for (int lineNumber = 1; std::getline(*input, line); ++lineNumber)
+        {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#')
+            {
+                continue;
+            }
+            BatchInstance instance;
+            try
+            {
+                instance = parseBatchLine(line, numInstances, defaultTimeLimited, defaultTimeLimit);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Error: " << manifest << ":" << lineNumber << ": " << e.what() << std::endl;
+                numErrors++;
+                continue;
+            }
+            numInstances++;
+
+            pool.post([&, instance]()
+                      {
+                auto start = std::chrono::steady_clock::now();
+                try
+                {
+                    std::unique_ptr<CoolingSchedule> coolingSchedule = makeCoolingSchedule(instance.coolingMethod, initialTemperature);
+                    if (!coolingSchedule)
+                    {
+                        throw std::invalid_argument("invalid cooling method '" + instance.coolingMethod + "'");
+                    }
+                    std::shared_ptr<const std::vector<uint8_t>> jobDurations = cache.get(instance.filename);
+                    int numJobs = jobDurations->size();
+
+                    Xoshiro256 rng(deriveSeed(deriveSeed(masterSeed, instance.index), 0));
+                    SchedulingSolution solution(numJobs, instance.numProcessors, *jobDurations, buildInitialAssignment(initMethod, *jobDurations, instance.numProcessors, rng), objective);
+                    double initialCost = solution.getCost();
+                    SchedulingMutation mutation = mutationPrototype;
+                    visitCoolingSchedule(*coolingSchedule, [&](const auto &cooling)
+                                         {
+                        SimulatedAnnealing sa(&solution, &mutation, &cooling, initialTemperature, maxIterations, maxNoImprovementCount, rng);
+                        if (instance.timeLimited)
+                        {
+                            sa.setDeadline(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(instance.timeLimit)));
+                        }
+                        sa.run();
+                        writeResult(instance, numJobs, initialCost, sa.getBestCost(), sa.getIterations(),
+                                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), "ok"); });
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "Error: instance " << instance.index << " (" << instance.filename << "): " << e.what() << std::endl;
+                    writeResult(instance, 0, -1, -1, 0, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), "error");
+                } });
+        }
+        pool.wait();
+
+        std::cerr << "Solved " << numInstances << " instances on " << numThreads << " threads in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count() << " s" << std::endl;
+        if (numErrors > 0)
+        {
+            return 1;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,341 +1,151 @@
 #include <iostream>
 #include <vector>
-#include <algorithm>
 #include <random>
 #include <cmath>
-#include <limits>
 #include <chrono>
 #include <memory>
-#include <fstream>
-#include <sstream>
 
-// Абстрактный класс для представления решения
-class Solution
-{
-public:
-    // Абстрактный метод для получения стоимости текущего решения
-    virtual double getCost() const = 0;
-    // Абстрактный метод для печати текущего решения
-    virtual void print() const = 0;
-    // Метод для создания копии текущего решения
-    virtual std::shared_ptr<Solution> clone() const = 0;
-};
-
-// Абстрактный класс для операции изменения (мутации) решения
-class MutationOperation
-{
-public:
-    // Абстрактный метод для выполнения мутации решения
-    virtual void mutate(Solution &solution) = 0;
-};
+#include "src/annealing.h"
+#include "src/scheduling.h"
+#include "src/job_loader.h"
+#include "src/options.h"
+#include "src/progress.h"
+#include "src/instrumentation.h"
+#include "src/simulated_annealing.h"
 
-// Класс для представления решения задачи планирования
-class SchedulingSolution : public Solution
+int main(int argc, char *argv[])
 {
-public:
-    SchedulingSolution(int numJobs, int numProcessors, const std::vector<uint8_t> &jobDurations)
-        : numJobs(numJobs), numProcessors(numProcessors), jobDurations(jobDurations), distribution(0, numProcessors - 1)
+    CommandLine commandLine;
+    try
     {
-        // Инициализация генератора случайных чисел
-        std::random_device rd;
-        rng.seed(rd());
-
-        // Инициализация случайного начального решения
-        schedule.assign(numJobs, std::vector<uint8_t>(numProcessors, 0));
-        processorLoads.resize(numProcessors, 0);
-        for (int i = 0; i < numJobs; ++i)
-        {
-            int processor = distribution(rng); // Выбираем случайный процессор для каждой работы
-            schedule[i][processor] = 1;
-            processorLoads[processor] += jobDurations[i];
-        }
+        commandLine = CommandLine(argc, argv, {"init", "moves", "objective", "speeds", "affinity", "time-limit", "progress", "checkpoint", "checkpoint-interval", "resume", "seed"});
     }
-
-    double getCost() const override
+    catch (const std::invalid_argument &e)
     {
-        // Критерий K1: Разбалансированность расписания
-        int Tmax = *std::max_element(processorLoads.begin(), processorLoads.end()); // Максимальная нагрузка
-        int Tmin = *std::min_element(processorLoads.begin(), processorLoads.end()); // Минимальная нагрузка
-        return static_cast<double>(Tmax - Tmin);                                    // Разница между максимальной и минимальной нагрузкой
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
     }
-
-    void print() const override
+    const std::vector<std::string> &args = commandLine.positional();
+    if (args.size() != 3)
     {
-        // Печать расписания работ
-        // for (int i = 0; i < numJobs; ++i)
-        // {
-        //     std::cout << "Job " << i << ": ";
-        //     for (int j = 0; j < numProcessors; ++j)
-        //     {
-        //         std::cout << schedule[i][j] << " ";
-        //     }
-        //     std::cout << std::endl;
-        // }
-        // Печать нагрузки на каждом процессоре
-        // for (int i = 0; i < numProcessors; ++i)
-        // {
-        //     std::cout << "Processor " << i << ": Load = " << processorLoads[i] << std::endl;
-        // }
+        std::cerr << "Usage: " << argv[0] << " <filename> <num_processors> <cooling_method> [--init random|lpt|kk] [--moves adaptive|move,swap,kexchange,targeted,batch] [--objective imbalance|makespan|variance|imbalance+0.5*makespan] [--speeds file] [--affinity file] [--time-limit seconds] [--progress file|-] [--checkpoint file] [--checkpoint-interval seconds] [--resume file] [--seed S]" << std::endl;
+        std::cerr << "Cooling methods: boltzmann, cauchy, logarithmic" << std::endl;
+        return 1;
     }
 
-    std::shared_ptr<Solution> clone() const override
-    {
-        // Создание копии текущего решения
-        return std::make_shared<SchedulingSolution>(*this);
-    }
+    std::string filename = args[0];
+    int numProcessors = std::stoi(args[1]);
+    std::string coolingMethod = args[2];
+    std::string initMethod = commandLine.get("init", "random");
+    std::string moveSpec = commandLine.get("moves", "adaptive");
 
-    void updateSchedule(int jobIndex, int oldProcessor, int newProcessor)
+    // Инициализация метода понижения температуры в зависимости от параметра
+    double initialTemperature = 100.0;
+    std::unique_ptr<CoolingSchedule> coolingSchedule = makeCoolingSchedule(coolingMethod, initialTemperature);
+    if (!coolingSchedule)
     {
-        // Обновляем нагрузку процессоров и матрицу расписания
-        schedule[jobIndex][oldProcessor] = 0; // Убираем работу с текущего процессора
-        schedule[jobIndex][newProcessor] = 1; // Перемещаем работу на новый процессор
-        processorLoads[oldProcessor] -= jobDurations[jobIndex];
-        processorLoads[newProcessor] += jobDurations[jobIndex];
+        std::cerr << "Invalid cooling method. Available methods: boltzmann, cauchy, logarithmic" << std::endl;
+        return 1;
     }
 
-    int getNumJobs() const { return numJobs; }
-    int getNumProcessors() const { return numProcessors; }
-    int getJobProcessor(int jobIndex) const
+    try
     {
-        for (int j = 0; j < numProcessors; ++j)
+        // Срок отсчитывается от запуска, включая загрузку и построение начального решения
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<ProgressSink> progress;
+        if (commandLine.has("progress"))
         {
-            if (schedule[jobIndex][j] == 1)
-            {
-                return j;
-            }
+            progress = std::make_unique<ProgressSink>(commandLine.get("progress", "-"));
         }
-        return -1;
-    }
-    std::mt19937 &getRng() { return rng; }
-    std::uniform_int_distribution<int> &getDistribution() { return distribution; }
-
-private:
-    int numJobs;                                     // Количество работ
-    int numProcessors;                               // Количество процессоров
-    std::vector<uint8_t> jobDurations;                   // Длительности работ
-    std::vector<std::vector<uint8_t>> schedule;          // Матрица расписания
-    std::vector<int> processorLoads;                 // Нагрузки на процессоры
-    mutable std::mt19937 rng;                        // Генератор случайных чисел
-    std::uniform_int_distribution<int> distribution; // Распределение для выбора процессора
-};
 
-// Класс для операции мутации решения задачи планирования
-class SchedulingMutation : public MutationOperation
-{
-public:
-    void mutate(Solution &solution) override
-    {
-        SchedulingSolution &schedSolution = dynamic_cast<SchedulingSolution &>(solution);
-        std::mt19937 &rng = schedSolution.getRng();
-        std::uniform_int_distribution<int> &distribution = schedSolution.getDistribution();
-        std::uniform_int_distribution<int> jobDist(0, schedSolution.getNumJobs() - 1);
+        // Загружаем длительности работ из файла
+        std::vector<uint8_t> jobDurations = loadJobDurations(filename);
+        int numJobs = jobDurations.size();
 
-        int jobIndex = jobDist(rng); // Выбираем случайную работу
-        int oldProcessor = schedSolution.getJobProcessor(jobIndex);
-        int newProcessor = distribution(rng); // Выбираем новый случайный процессор
-        while (newProcessor == oldProcessor)
+        // Генератор цепочки выводится из главного зерна и номера цепочки; без --seed зерно случайное
+        uint64_t masterSeed = commandLine.has("seed") ? std::stoull(commandLine.get("seed", "0")) : randomMasterSeed();
+        Xoshiro256 rng(deriveSeed(masterSeed, 0));
+
+        // Начальное решение: случайное или построенное жадной эвристикой
+        SchedulingObjective objective = parseObjective(commandLine.get("objective", "imbalance"));
+        // Скорости процессоров и допустимые процессоры работ; без файлов процессоры одинаковы
+        std::shared_ptr<const ProcessorModel> processorModel = loadProcessorModel(numJobs, numProcessors, commandLine.get("speeds", ""), commandLine.get("affinity", ""));
+        // При возобновлении назначение, генератор и состояние отжига берутся из контрольной точки,
+        // поэтому начальное решение не строится
+        std::unique_ptr<CheckpointReader> resumeState;
+        if (commandLine.has("resume"))
         {
-            newProcessor = distribution(rng); // Убеждаемся, что новый процессор отличается от старого
+            Checkpoint checkpoint = loadCheckpointFile(commandLine.get("resume", ""));
+            checkCheckpointInstance(checkpoint, CheckpointKind::Sequential, jobDurations, numProcessors);
+            resumeState = std::make_unique<CheckpointReader>(std::move(checkpoint.payload));
         }
-
-        schedSolution.updateSchedule(jobIndex, oldProcessor, newProcessor); // Обновляем расписание
-    }
-};
-
-// Абстрактный класс для закона понижения температуры
-class CoolingSchedule
-{
-public:
-    // Абстрактный метод для получения следующей температуры
-    virtual double getNextTemperature(double currentTemperature, int iteration) const = 0;
-};
-
-// Класс для закона Больцмана
-class BoltzmannCooling : public CoolingSchedule
-{
-public:
-    BoltzmannCooling(double initialTemperature) : initialTemperature(initialTemperature) {}
-
-    double getNextTemperature(double currentTemperature, int iteration) const override
-    {
-        return initialTemperature / std::log(1 + iteration + 1); // Температура уменьшается по закону Больцмана
-    }
-
-private:
-    double initialTemperature; // Начальная температура
-};
-
-// Класс для закона Коши
-class CauchyCooling : public CoolingSchedule
-{
-public:
-    CauchyCooling(double initialTemperature) : initialTemperature(initialTemperature) {}
-
-    double getNextTemperature(double currentTemperature, int iteration) const override
-    {
-        return initialTemperature / (1 + iteration); // Температура уменьшается по закону Коши
-    }
-
-private:
-    double initialTemperature; // Начальная температура
-};
-
-// Класс для закона T = T_0 * ln(1 + i) / (1 + i)
-class LogarithmicCooling : public CoolingSchedule
-{
-public:
-    LogarithmicCooling(double initialTemperature) : initialTemperature(initialTemperature) {}
-
-    double getNextTemperature(double currentTemperature, int iteration) const override
-    {
-        return initialTemperature * std::log(1 + iteration + 1) / (1 + iteration); // Логарифмическое уменьшение температуры
-    }
-
-private:
-    double initialTemperature; // Начальная температура
-};
-
-// Основной класс для алгоритма имитации отжига
-class SimulatedAnnealing
-{
-public:
-    SimulatedAnnealing(Solution *solution, MutationOperation *mutationOperation, CoolingSchedule *coolingSchedule, double initialTemperature, int maxIterations, int maxNoImprovementCount)
-        : solution(solution), mutationOperation(mutationOperation), coolingSchedule(coolingSchedule), temperature(initialTemperature), maxIterations(maxIterations), maxNoImprovementCount(maxNoImprovementCount) {}
-
-    void run()
-    {
-        int iteration = 0;
-        double bestCost = solution->getCost(); // Изначальная стоимость решения
-        auto bestSolution = solution->clone(); // Копия наилучшего решения
-        int noImprovementCount = 0;            // Счетчик количества итераций без улучшения
-
-        while (iteration < maxIterations && noImprovementCount < maxNoImprovementCount)
+        SchedulingSolution solution(numJobs, numProcessors, jobDurations,
+                                    resumeState ? std::vector<int>(numJobs, 0) : buildInitialAssignment(initMethod, jobDurations, numProcessors, rng), objective, processorModel);
+        if (!resumeState)
         {
-            // Клонируем лучшее решение и применяем к нему мутацию
-            auto currentSolution = bestSolution->clone();
-            mutationOperation->mutate(*currentSolution);
-            double currentCost = currentSolution->getCost(); // Стоимость мутированного решения
-            if (currentCost < bestCost)
+            // Генератор возобновленного прогона берется из контрольной точки, а не из зерна
+            std::cout << "Seed manifest: " << seedManifest(masterSeed, {0}) << std::endl;
+            std::cout << "Initial solution (" << initMethod << ") cost: " << solution.getCost() << std::endl;
+        }
+        SchedulingMutation mutationOperation(parseMoveKinds(moveSpec));
+        std::unique_ptr<CheckpointSink> checkpoints;
+        if (commandLine.has("checkpoint"))
+        {
+            checkpoints = std::make_unique<CheckpointSink>(commandLine.get("checkpoint", ""), CheckpointKind::Sequential, jobDurations, numProcessors);
+        }
+
+        int maxIterations = 100000;
+        int maxNoImprovementCount = 100;
+        // Закон охлаждения выбран в рантайме, а цикл отжига инстанцируется под конкретный тип
+        visitCoolingSchedule(*coolingSchedule, [&](const auto &cooling)
+                             {
+            SimulatedAnnealing sa(&solution, &mutationOperation, &cooling, initialTemperature, maxIterations, maxNoImprovementCount, rng);
+            if (commandLine.has("time-limit"))
             {
-                // Если новое решение лучше, обновляем наилучшее решение
-                bestCost = currentCost;
-                noImprovementCount = 0;
-                bestSolution = currentSolution;
+                sa.setDeadline(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(std::stod(commandLine.get("time-limit", "0")))));
             }
-            else
+            sa.setProgress(progress.get());
+            if (checkpoints)
             {
-                // Если решение хуже, то принимаем его с некоторой вероятностью (правило Метрополиса)
-                double acceptanceProbability = std::exp(-(currentCost - bestCost) / temperature);
-                if (acceptanceProbability >= static_cast<double>(rand()) / RAND_MAX)
-                {
-                    // Принять ухудшающее решение и обновить лучшее решение
-                    noImprovementCount = 0;
-                    bestSolution = currentSolution;
-                }
-                else
-                {
-                    // Если решение не принято, увеличиваем счетчик итераций без улучшений
-                    noImprovementCount++;
-                }
+                sa.setCheckpoint(checkpoints.get(), std::stod(commandLine.get("checkpoint-interval", "10")));
             }
-            // Обновляем температуру согласно закону понижения температуры
-            temperature = coolingSchedule->getNextTemperature(temperature, iteration);
-            iteration++;
-        }
-        // Печатаем наилучшее найденное решение
-        bestSolution->print();
-        std::cout << "Best solution found with cost: " << bestCost << std::endl;
-    }
-
-private:
-    Solution *solution;                   // Текущее решение
-    MutationOperation *mutationOperation; // Операция мутации решения
-    CoolingSchedule *coolingSchedule;     // План понижения температуры
-    double temperature;                   // Текущая температура
-    int maxIterations;                    // Максимальное количество итераций
-    int maxNoImprovementCount;            // Условие останова или максимально число иттераций без улучшений
-};
-
+            if (resumeState)
+            {
+                sa.resume(*resumeState);
+                std::cout << "Initial solution (resumed) cost: " << solution.getCost() << std::endl;
+            }
+            sa.run();
 
-std::vector<uint8_t> loadJobDurationsFromCSV(const std::string &filename)
-{
-    std::vector<uint8_t> jobDurations;
-    std::ifstream file(filename);
-    if (!file.is_open())
-    {
-        throw std::runtime_error("Unable to open file " + filename);
-    }
+            // Печатаем наилучшее найденное решение
+            solution.print();
+            std::cout << "Best solution found with cost: " << sa.getBestCost() << std::endl;
+            if (objective.describe() != "imbalance")
+            {
+                std::cout << "Objective: " << objective.describe() << ", imbalance: " << solution.getImbalance() << ", makespan: " << solution.getMakespan()
+                          << ", variance: " << solution.getLoadVariance() << std::endl;
+            }
+            std::cout << "Iterations: " << sa.getIterations() << ", iterations per second: " << (sa.getSeconds() > 0 ? sa.getIterations() / sa.getSeconds() : 0) << std::endl;
+            if (commandLine.has("time-limit"))
+            {
+                std::cout << "Chains: " << sa.getChains() << ", elapsed seconds: " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << std::endl;
+            } });
 
-    std::string line;
-    bool isHeader = true;
-    while (std::getline(file, line))
-    {
-        if (isHeader)
+        if (checkpoints && !checkpoints->getError().empty())
         {
-            isHeader = false;
-            continue;
+            std::cerr << "Warning: " << checkpoints->getError() << std::endl;
         }
-        std::stringstream ss(line);
-        std::string jobId, durationStr;
-        std::getline(ss, jobId, ',');
-        std::getline(ss, durationStr, ',');
-        jobDurations.push_back(std::stoi(durationStr));
-    }
-
-    file.close();
-    return jobDurations;
-}
-
-int main(int argc, char *argv[])
-{
-    if (argc != 4)
-    {
-        std::cerr << "Usage: " << argv[0] << " <filename> <num_processors> <cooling_method>" << std::endl;
-        std::cerr << "Cooling methods: boltzmann, cauchy, logarithmic" << std::endl;
-        return 1;
-    }
 
-    std::string filename = argv[1];
-    int numProcessors = std::stoi(argv[2]);
-    std::string coolingMethod = argv[3];
-
-    // Указатель на план понижения температуры
-    std::unique_ptr<CoolingSchedule> coolingSchedule;
-
-    // Инициализация метода понижения температуры в зависимости от параметра
-    double initialTemperature = 100.0;
-    if (coolingMethod == "boltzmann")
-    {
-        coolingSchedule = std::make_unique<BoltzmannCooling>(initialTemperature);
-    }
-    else if (coolingMethod == "cauchy")
-    {
-        coolingSchedule = std::make_unique<CauchyCooling>(initialTemperature);
-    }
-    else if (coolingMethod == "logarithmic")
-    {
-        coolingSchedule = std::make_unique<LogarithmicCooling>(initialTemperature);
-    }
-    else
-    {
-        std::cerr << "Invalid cooling method. Available methods: boltzmann, cauchy, logarithmic" << std::endl;
-        return 1;
-    }
-
-    try
-    {
-        // Загружаем длительности работ из файла
-        std::vector<uint8_t> jobDurations = loadJobDurationsFromCSV(filename);
-        int numJobs = jobDurations.size();
-
-        SchedulingSolution solution(numJobs, numProcessors, jobDurations);
-        SchedulingMutation mutationOperation;
-
-        int maxIterations = 100000;
-        int maxNoImprovementCount = 100;
-        SimulatedAnnealing sa(&solution, &mutationOperation, coolingSchedule.get(), initialTemperature, maxIterations, maxNoImprovementCount);
-
-        sa.run();
+        // Итоговые вероятности выбора ходов показывают, какие ходы оказались полезны
+        if (mutationOperation.getMoves().size() > 1)
+        {
+            std::cout << "Move probabilities:";
+            for (size_t i = 0; i < mutationOperation.getMoves().size(); ++i)
+            {
+                std::cout << " " << moveKindName(mutationOperation.getMoves()[i]) << " " << mutationOperation.getProbabilities()[i];
+            }
+            std::cout << std::endl;
+        }
+        ANNEALING_REPORT(std::cerr);
     }
     catch (const std::exception &e)
     {
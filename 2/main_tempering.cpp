@@ -0,0 +1,275 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <barrier>
+
+#include "src/annealing.h"
+#include "src/scheduling.h"
+#include "src/job_loader.h"
+#include "src/options.h"
+#include "src/instrumentation.h"
+
+// Отжиг с обменом реплик (parallel tempering).
+// Реплики работают при фиксированных температурах лестницы и периодически
+// пытаются обменяться решениями с соседними по температуре репликами.
+// Типы решения и мутации - параметры шаблона, чтобы проход Метрополиса обходился без виртуальных вызовов
+template <typename SolutionT, typename MutationT>
+class ParallelTempering
+{
+public:
+    ParallelTempering(const SolutionT &initialSolution, const MutationT &mutationPrototype, const CoolingSchedule *coolingSchedule, double initialTemperature, int numReplicas, int numThreads, int sweepLength, int maxIterations, int maxNoImprovementSweeps, uint64_t masterSeed)
+        : numReplicas(numReplicas), numThreads(std::min(numThreads, numReplicas)), sweepLength(sweepLength), maxIterations(maxIterations), maxNoImprovementSweeps(maxNoImprovementSweeps), replicas(numReplicas), swapRng(deriveSeed(masterSeed, numReplicas + 1))
+    {
+        // Лестница температур строится тем же законом охлаждения, что и обычный отжиг:
+        // ступени берутся в точках i_r = maxIterations^(1 - r / (R - 1)) - 1, распределенных геометрически.
+        // Ступень 0 самая холодная, последняя ступень соответствует началу обычного отжига
+        for (int r = 0; r < numReplicas; ++r)
+        {
+            double fraction = numReplicas > 1 ? static_cast<double>(r) / (numReplicas - 1) : 0.0;
+            int iteration = static_cast<int>(std::round(std::pow(maxIterations, 1.0 - fraction))) - 1;
+            temperatures.push_back(coolingSchedule->getNextTemperature(initialTemperature, iteration));
+
+            replicas[r].solution = cloneSolution(initialSolution);
+            replicas[r].cost = replicas[r].solution->getCost();
+            replicas[r].bestCost = replicas[r].cost;
+            replicas[r].solution->markBest();
+            replicas[r].rng.seed(deriveSeed(masterSeed, r + 1));
+            replicas[r].mutation = mutationPrototype;
+        }
+        swapAttempts.assign(numReplicas, 0);
+        swapAccepts.assign(numReplicas, 0);
+        bestCost = replicas[0].cost;
+        bestSolution = cloneSolution(*replicas[0].solution);
+    }
+
+    void run()
+    {
+        // Потоки живут весь прогон: после каждого прохода они встречаются на барьере,
+        // а обмен репликами выполняется в завершающей функции барьера одним потоком
+        std::barrier sync(numThreads, [this]() noexcept { exchangeReplicas(); });
+        std::vector<std::thread> workers;
+        for (int t = 0; t < numThreads; ++t)
+        {
+            workers.emplace_back([this, t, &sync]()
+                                 {
+                while (!finished)
+                {
+                    for (int r = t; r < numReplicas; r += numThreads)
+                    {
+                        sweep(r);
+                    }
+                    sync.arrive_and_wait();
+                } });
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        // Печатаем лестницу температур и долю принятых обменов между соседними ступенями
+        for (int r = 0; r + 1 < numReplicas; ++r)
+        {
+            double rate = swapAttempts[r] > 0 ? static_cast<double>(swapAccepts[r]) / swapAttempts[r] : 0.0;
+            std::cout << "T[" << r << "] = " << temperatures[r] << " <-> T[" << r + 1 << "] = " << temperatures[r + 1]
+                      << ", swap acceptance: " << rate << std::endl;
+        }
+        bestSolution->print();
+        std::cout << "Best solution found with cost: " << bestCost << std::endl;
+        ANNEALING_REPORT(std::cerr);
+    }
+
+private:
+    // Данные реплики выровнены по строке кэша, чтобы потоки не делили строки
+    struct alignas(64) Replica
+    {
+        std::shared_ptr<SolutionT> solution;
+        double cost = 0;
+        double bestCost = 0; // Стоимость лучшего состояния, отмеченного в решении (markBest)
+        Xoshiro256 rng;
+        MutationT mutation; // Своя копия: мутация может хранить статистику выбора ходов
+    };
+
+    // clone() возвращает базовый тип, а реплики хранят конкретный
+    static std::shared_ptr<SolutionT> cloneSolution(const SolutionT &solution)
+    {
+        return std::static_pointer_cast<SolutionT>(solution.clone());
+    }
+
+    // Проход Метрополиса длиной sweepLength при температуре ступени
+    void sweep(int rung)
+    {
+        Replica &replica = replicas[rung];
+        double temperature = temperatures[rung];
+        for (int i = 0; i < sweepLength; ++i)
+        {
+            ANNEALING_COUNT(Iterations);
+            ANNEALING_TIMED(Mutate, replica.mutation.mutate(*replica.solution, replica.rng));
+            double currentCost = ANNEALING_TIMED(Cost, replica.solution->getCost());
+            double delta = currentCost - replica.cost;
+            if (delta <= 0 || ANNEALING_TIMED(Accept, metropolisAccept(delta, temperature, replica.rng)))
+            {
+                if (delta > 0)
+                {
+                    ANNEALING_COUNT(AcceptedWorse);
+                }
+                ANNEALING_TIMED(Commit, replica.solution->commit());
+                replica.cost = currentCost;
+                // Лучшее состояние отмечается сразу: ухудшающий ход позже в проходе его не потеряет
+                if (currentCost < replica.bestCost)
+                {
+                    ANNEALING_COUNT(Improvements);
+                    replica.bestCost = currentCost;
+                    replica.solution->markBest();
+                }
+            }
+            else
+            {
+                ANNEALING_COUNT(Rejected);
+                ANNEALING_TIMED(Rollback, replica.solution->rollback());
+            }
+        }
+    }
+
+    // Выполняется одним потоком между проходами, пока остальные ждут на барьере
+    void exchangeReplicas()
+    {
+        // Чередуем четные и нечетные пары соседних ступеней
+        int offset = sweepCount % 2;
+        for (int r = offset; r + 1 < numReplicas; r += 2)
+        {
+            double exponent = (replicas[r].cost - replicas[r + 1].cost) * (1.0 / temperatures[r] - 1.0 / temperatures[r + 1]);
+            swapAttempts[r]++;
+            if (exponent >= 0 || std::exp(exponent) >= swapRng.uniformReal())
+            {
+                std::swap(replicas[r].solution, replicas[r + 1].solution);
+                std::swap(replicas[r].cost, replicas[r + 1].cost);
+                std::swap(replicas[r].bestCost, replicas[r + 1].bestCost);
+                swapAccepts[r]++;
+            }
+        }
+
+        // Лучшие состояния реплик отмечены внутри проходов; наилучшее из них восстанавливается
+        // в копии решения, а сама реплика продолжает цепочку из текущего состояния
+        int bestReplica = 0;
+        for (int r = 1; r < numReplicas; ++r)
+        {
+            if (replicas[r].bestCost < replicas[bestReplica].bestCost)
+            {
+                bestReplica = r;
+            }
+        }
+        if (replicas[bestReplica].bestCost < bestCost)
+        {
+            bestCost = replicas[bestReplica].bestCost;
+            bestSolution = cloneSolution(*replicas[bestReplica].solution);
+            bestSolution->restoreBest();
+            noImprovementSweeps = 0;
+        }
+        else
+        {
+            noImprovementSweeps++;
+        }
+
+        sweepCount++;
+        finished = static_cast<long long>(sweepCount) * sweepLength >= maxIterations || noImprovementSweeps >= maxNoImprovementSweeps;
+    }
+
+    int numReplicas;                      // Количество реплик (ступеней лестницы)
+    int numThreads;                       // Количество рабочих потоков
+    int sweepLength;                      // Количество шагов реплики между обменами
+    int maxIterations;                    // Максимальное количество шагов каждой реплики
+    int maxNoImprovementSweeps;           // Количество проходов без улучшения до останова
+    std::vector<double> temperatures;     // Лестница температур по возрастанию
+    std::vector<Replica> replicas;        // Реплики по ступеням лестницы
+    std::vector<long long> swapAttempts;  // Попытки обмена ступеней r и r + 1
+    std::vector<long long> swapAccepts;   // Принятые обмены ступеней r и r + 1
+    Xoshiro256 swapRng;                   // Генератор для решений об обмене
+    std::shared_ptr<SolutionT> bestSolution;
+    double bestCost;
+    int sweepCount = 0;
+    int noImprovementSweeps = 0;
+    bool finished = false;
+};
+
+int main(int argc, char *argv[])
+{
+    CommandLine commandLine;
+    try
+    {
+        commandLine = CommandLine(argc, argv, {"init", "moves", "objective", "speeds", "affinity", "seed"});
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    const std::vector<std::string> &args = commandLine.positional();
+    if (args.size() != 5)
+    {
+        std::cerr << "Usage: " << argv[0] << " <filename> <num_processors> <cooling_method> <num_replicas> <num_threads> [--init random|lpt|kk] [--moves adaptive|move,swap,kexchange,targeted,batch] [--objective imbalance|makespan|variance|imbalance+0.5*makespan] [--speeds file] [--affinity file] [--seed S]" << std::endl;
+        std::cerr << "Cooling methods: boltzmann, cauchy, logarithmic" << std::endl;
+        return 1;
+    }
+
+    std::string filename = args[0];
+    int numProcessors = std::stoi(args[1]);
+    std::string coolingMethod = args[2];
+    int numReplicas = std::stoi(args[3]);
+    int numThreads = std::stoi(args[4]);
+    std::string initMethod = commandLine.get("init", "random");
+    std::string moveSpec = commandLine.get("moves", "adaptive");
+
+    // Закон охлаждения задает лестницу температур реплик
+    double initialTemperature = 100.0;
+    std::unique_ptr<CoolingSchedule> coolingSchedule = makeCoolingSchedule(coolingMethod, initialTemperature);
+    if (!coolingSchedule)
+    {
+        std::cerr << "Invalid cooling method. Available methods: boltzmann, cauchy, logarithmic" << std::endl;
+        return 1;
+    }
+    if (numReplicas < 1 || numThreads < 1)
+    {
+        std::cerr << "Number of replicas and threads must be positive" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::vector<uint8_t> jobDurations = loadJobDurations(filename);
+        int numJobs = jobDurations.size();
+
+        // Цепочка 0 строит начальное решение, реплики получают цепочки 1..R, обмены - цепочку R + 1
+        uint64_t masterSeed = commandLine.has("seed") ? std::stoull(commandLine.get("seed", "0")) : randomMasterSeed();
+        Xoshiro256 initRng(deriveSeed(masterSeed, 0));
+        std::vector<uint64_t> chainIds;
+        for (int chain = 0; chain <= numReplicas + 1; ++chain)
+        {
+            chainIds.push_back(chain);
+        }
+        std::cout << "Seed manifest: " << seedManifest(masterSeed, chainIds) << std::endl;
+
+        SchedulingObjective objective = parseObjective(commandLine.get("objective", "imbalance"));
+        std::shared_ptr<const ProcessorModel> processorModel = loadProcessorModel(numJobs, numProcessors, commandLine.get("speeds", ""), commandLine.get("affinity", ""));
+        SchedulingSolution solution(numJobs, numProcessors, jobDurations, buildInitialAssignment(initMethod, jobDurations, numProcessors, initRng), objective, processorModel);
+        std::cout << "Initial solution (" << initMethod << ") cost: " << solution.getCost() << std::endl;
+        SchedulingMutation mutationOperation(parseMoveKinds(moveSpec));
+
+        int maxIterations = 100000;
+        int sweepLength = 1000;
+        int maxNoImprovementSweeps = 20;
+        ParallelTempering pt(solution, mutationOperation, coolingSchedule.get(), initialTemperature, numReplicas, numThreads, sweepLength, maxIterations, maxNoImprovementSweeps, masterSeed);
+
+        pt.run();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+#ifndef ANNEALING_H
+#define ANNEALING_H
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "random.h"
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Абстрактный класс для представления решения
+class Solution
+{
+public:
+    virtual ~Solution() = default;
+    // Абстрактный метод для получения стоимости текущего решения
+    virtual double getCost() const = 0;
+    // Абстрактный метод для печати текущего решения
+    virtual void print() const = 0;
+    // Метод для создания копии текущего решения
+    virtual std::shared_ptr<Solution> clone() const = 0;
+    // Фиксирует изменения, внесенные мутациями после последнего commit/rollback
+    virtual void commit() = 0;
+    // Откатывает изменения, внесенные мутациями после последнего commit/rollback
+    virtual void rollback() = 0;
+    // Запоминает текущее (зафиксированное) состояние как лучшее
+    virtual void markBest() = 0;
+    // Возвращает решение в состояние последнего markBest (или создания решения)
+    virtual void restoreBest() = 0;
+    // Запись зафиксированного состояния, включая лучшее, в контрольную точку (см. checkpoint.h)
+    virtual void saveState(CheckpointWriter &writer) const = 0;
+    // Восстановление состояния, записанного saveState, так что отжиг продолжается побитово так же
+    virtual void loadState(CheckpointReader &reader) = 0;
+};
+
+// Абстрактный класс для операции изменения (мутации) решения
+class MutationOperation
+{
+public:
+    virtual ~MutationOperation() = default;
+    // Абстрактный метод для выполнения мутации решения на месте.
+    // Мутация остается незафиксированной до вызова Solution::commit или Solution::rollback.
+    // Случайные числа берутся из генератора цепочки, выполняющей мутацию
+    virtual void mutate(Solution &solution, Xoshiro256 &rng) = 0;
+    // Состояние мутации для контрольной точки; мутации без состояния ничего не записывают
+    virtual void saveState(CheckpointWriter &) const {}
+    virtual void loadState(CheckpointReader &) {}
+};
+
+// Абстрактный класс для закона понижения температуры
+class CoolingSchedule
+{
+public:
+    virtual ~CoolingSchedule() = default;
+    // Абстрактный метод для получения следующей температуры
+    virtual double getNextTemperature(double currentTemperature, int iteration) const = 0;
+};
+
+// Класс для закона Больцмана
+class BoltzmannCooling final : public CoolingSchedule
+{
+public:
+    BoltzmannCooling(double initialTemperature) : initialTemperature(initialTemperature) {}
+
+    double getNextTemperature(double currentTemperature, int iteration) const override
+    {
+        return initialTemperature / std::log(1 + iteration + 1); // Температура уменьшается по закону Больцмана
+    }
+
+private:
+    double initialTemperature; // Начальная температура
+};
+
+// Класс для закона Коши
+class CauchyCooling final : public CoolingSchedule
+{
+public:
+    CauchyCooling(double initialTemperature) : initialTemperature(initialTemperature) {}
+
+    double getNextTemperature(double currentTemperature, int iteration) const override
+    {
+        return initialTemperature / (1 + iteration); // Температура уменьшается по закону Коши
+    }
+
+private:
+    double initialTemperature; // Начальная температура
+};
+
+// Класс для закона T = T_0 * ln(1 + i) / (1 + i)
+class LogarithmicCooling final : public CoolingSchedule
+{
+public:
+    LogarithmicCooling(double initialTemperature) : initialTemperature(initialTemperature) {}
+
+    double getNextTemperature(double currentTemperature, int iteration) const override
+    {
+        return initialTemperature * std::log(1 + iteration + 1) / (1 + iteration); // Логарифмическое уменьшение температуры
+    }
+
+private:
+    double initialTemperature; // Начальная температура
+};
+
+// Заранее вычисленная таблица температур для первых size итераций.
+// temperatures[i] - температура, при которой выполняется итерация i: T_0 = initialTemperature,
+// T_{i+1} = getNextTemperature(T_i, i). Таблица неизменяема и может разделяться потоками,
+// а цикл отжига больше не вызывает log из закона охлаждения на каждой итерации
+template <typename CoolingT>
+class TemperatureTable
+{
+public:
+    TemperatureTable(const CoolingT &coolingSchedule, double initialTemperature, int size)
+        : coolingSchedule(coolingSchedule)
+    {
+        temperatures.resize(std::max(size, 1));
+        temperatures[0] = initialTemperature;
+        // Тип закона известен при компиляции, поэтому этот цикл встраивается и считается пакетом
+        for (int i = 1; i < size; ++i)
+        {
+            temperatures[i] = coolingSchedule.getNextTemperature(temperatures[i - 1], i - 1);
+        }
+    }
+
+    // Температура итерации iteration; за пределами таблицы считается по закону охлаждения
+    double at(int iteration, double previousTemperature) const
+    {
+        if (iteration < static_cast<int>(temperatures.size()))
+        {
+            return temperatures[iteration];
+        }
+        return coolingSchedule.getNextTemperature(previousTemperature, iteration - 1);
+    }
+
+private:
+    const CoolingT &coolingSchedule;
+    std::vector<double> temperatures;
+};
+
+// Правило Метрополиса без exp: exp(-delta / T) >= u эквивалентно delta <= T * (-ln u),
+// а -ln u берется из табличной экспоненциальной величины генератора
+inline bool metropolisAccept(double delta, double temperature, Xoshiro256 &rng)
+{
+    return delta <= temperature * rng.exponential();
+}
+
+// Создание закона понижения температуры по имени из командной строки.
+// Для неизвестного имени возвращается nullptr
+inline std::unique_ptr<CoolingSchedule> makeCoolingSchedule(const std::string &coolingMethod, double initialTemperature)
+{
+    if (coolingMethod == "boltzmann")
+    {
+        return std::make_unique<BoltzmannCooling>(initialTemperature);
+    }
+    if (coolingMethod == "cauchy")
+    {
+        return std::make_unique<CauchyCooling>(initialTemperature);
+    }
+    if (coolingMethod == "logarithmic")
+    {
+        return std::make_unique<LogarithmicCooling>(initialTemperature);
+    }
+    return nullptr;
+}
+
+// Вызов function с конкретным типом закона охлаждения. Позволяет выбрать закон
+// по имени в рантайме, а шаблонный цикл отжига инстанцировать без виртуальных вызовов.
+// Неизвестные наследники CoolingSchedule передаются как базовый класс
+template <typename Function>
+decltype(auto) visitCoolingSchedule(const CoolingSchedule &coolingSchedule, Function &&function)
+{
+    if (auto *boltzmann = dynamic_cast<const BoltzmannCooling *>(&coolingSchedule))
+    {
+        return function(*boltzmann);
+    }
+    if (auto *cauchy = dynamic_cast<const CauchyCooling *>(&coolingSchedule))
+    {
+        return function(*cauchy);
+    }
+    if (auto *logarithmic = dynamic_cast<const LogarithmicCooling *>(&coolingSchedule))
+    {
+        return function(*logarithmic);
+    }
+    return function(coolingSchedule);
+}
+
+#endif // ANNEALING_H
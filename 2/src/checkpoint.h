@@ -0,0 +1,345 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+#include "job_loader.h"
+
+// Контрольная точка решателя - бинарный файл: заголовок CheckpointHeader и за ним полезная нагрузка,
+// которую последовательно записывают решатель, решение и мутация (CheckpointWriter) и в том же
+// порядке читают при возобновлении (CheckpointReader). Заголовок связывает точку с экземпляром задачи
+// (число работ и процессоров, контрольная сумма длительностей) и защищает нагрузку контрольной суммой
+
+// Вид решателя, записавшего контрольную точку
+enum class CheckpointKind : uint32_t
+{
+    Sequential = 1, // SimulatedAnnealing (main_solo)
+    IslandModel = 2 // runIslandModel (main_mult)
+};
+
+struct CheckpointHeader
+{
+    char magic[8];          // "SACHKPT1"
+    uint32_t version;       // Версия формата
+    uint32_t kind;          // CheckpointKind
+    uint64_t jobCount;      // Количество работ экземпляра
+    uint32_t numProcessors; // Количество процессоров
+    uint32_t reserved;
+    uint64_t jobsChecksum;    // jobFileChecksum длительностей работ
+    uint64_t payloadSize;     // Размер нагрузки в байтах
+    uint64_t payloadChecksum; // jobFileChecksum нагрузки
+};
+
+static_assert(sizeof(CheckpointHeader) == 56, "CheckpointHeader must be packed into 56 bytes");
+
+constexpr char checkpointMagic[8] = {'S', 'A', 'C', 'H', 'K', 'P', 'T', '1'};
+constexpr uint32_t checkpointVersion = 2;
+
+// Построитель нагрузки: значения и векторы тривиально копируемых типов подряд, без выравнивания
+class CheckpointWriter
+{
+public:
+    CheckpointWriter() = default;
+    // Продолжение нагрузки, начатой другим построителем
+    explicit CheckpointWriter(std::string prefix) : data(std::move(prefix)) {}
+
+    template <typename T>
+    void put(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Checkpoint values must be trivially copyable");
+        data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    // Вектор записывается длиной и элементами
+    template <typename T>
+    void putVector(const std::vector<T> &values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Checkpoint values must be trivially copyable");
+        put<uint64_t>(values.size());
+        data.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    void reserve(size_t size) { data.reserve(size); }
+    const std::string &payload() const { return data; }
+    std::string release() { return std::move(data); }
+
+private:
+    std::string data;
+};
+
+// Чтение нагрузки с проверкой границ; обрыв данных - исключение, а не чтение за концом буфера
+class CheckpointReader
+{
+public:
+    explicit CheckpointReader(std::string payload) : data(std::move(payload)) {}
+
+    template <typename T>
+    T get()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Checkpoint values must be trivially copyable");
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> getVector()
+    {
+        uint64_t size = get<uint64_t>();
+        if (size > (data.size() - position) / std::max<size_t>(sizeof(T), 1))
+        {
+            throw std::runtime_error("Checkpoint is truncated");
+        }
+        std::vector<T> values(size);
+        if (size > 0)
+        {
+            std::memcpy(values.data(), data.data() + position, size * sizeof(T));
+        }
+        position += size * sizeof(T);
+        return values;
+    }
+
+    bool atEnd() const { return position == data.size(); }
+
+private:
+    void require(size_t size) const
+    {
+        if (data.size() - position < size)
+        {
+            throw std::runtime_error("Checkpoint is truncated");
+        }
+    }
+
+    std::string data;
+    size_t position = 0;
+};
+
+// Прочитанная контрольная точка
+struct Checkpoint
+{
+    CheckpointHeader header;
+    std::string payload;
+};
+
+// Чтение контрольной точки с проверкой сигнатуры, версии и контрольной суммы
+inline Checkpoint loadCheckpointFile(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to open file " + filename);
+    }
+    Checkpoint checkpoint;
+    if (!file.read(reinterpret_cast<char *>(&checkpoint.header), sizeof(checkpoint.header)) ||
+        std::memcmp(checkpoint.header.magic, checkpointMagic, sizeof(checkpointMagic)) != 0)
+    {
+        throw std::runtime_error(filename + ": not a checkpoint file");
+    }
+    if (checkpoint.header.version != checkpointVersion)
+    {
+        throw std::runtime_error(filename + ": unsupported checkpoint version " + std::to_string(checkpoint.header.version));
+    }
+    checkpoint.payload.resize(checkpoint.header.payloadSize);
+    if (!file.read(checkpoint.payload.data(), checkpoint.payload.size()) || file.peek() != EOF)
+    {
+        throw std::runtime_error(filename + ": file size does not match checkpoint payload size");
+    }
+    if (jobFileChecksum(reinterpret_cast<const uint8_t *>(checkpoint.payload.data()), checkpoint.payload.size()) != checkpoint.header.payloadChecksum)
+    {
+        throw std::runtime_error(filename + ": checksum mismatch");
+    }
+    return checkpoint;
+}
+
+// Проверка, что контрольная точка записана тем же решателем для того же экземпляра задачи
+inline void checkCheckpointInstance(const Checkpoint &checkpoint, CheckpointKind kind, const std::vector<uint8_t> &jobDurations, int numProcessors)
+{
+    if (checkpoint.header.kind != static_cast<uint32_t>(kind))
+    {
+        throw std::runtime_error("Checkpoint was written by a different solver");
+    }
+    if (checkpoint.header.jobCount != jobDurations.size() || checkpoint.header.numProcessors != static_cast<uint32_t>(numProcessors) ||
+        checkpoint.header.jobsChecksum != jobFileChecksum(jobDurations.data(), jobDurations.size()))
+    {
+        throw std::runtime_error("Checkpoint was written for a different instance (jobs or number of processors differ)");
+    }
+}
+
+// Фоновая запись контрольных точек. Решатель отдает снимок состояния вместе с функцией сериализации;
+// и сериализацию, и запись на диск выполняет отдельный поток. Если поток еще занят предыдущей точкой,
+// ожидающая точка заменяется новой. Файл заменяется атомарно: запись во временный файл, fsync и rename,
+// поэтому прерывание или сбой системы во время записи оставляет предыдущую целую точку
+class CheckpointSink
+{
+public:
+    CheckpointSink(const std::string &path, CheckpointKind kind, const std::vector<uint8_t> &jobDurations, int numProcessors)
+        : path(path)
+    {
+        std::memcpy(header.magic, checkpointMagic, sizeof(checkpointMagic));
+        header.version = checkpointVersion;
+        header.kind = static_cast<uint32_t>(kind);
+        header.jobCount = jobDurations.size();
+        header.numProcessors = static_cast<uint32_t>(numProcessors);
+        header.reserved = 0;
+        header.jobsChecksum = jobFileChecksum(jobDurations.data(), jobDurations.size());
+        writer = std::thread([this]()
+                             { writerLoop(); });
+    }
+
+    ~CheckpointSink()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_one();
+        writer.join();
+    }
+
+    CheckpointSink(const CheckpointSink &) = delete;
+    CheckpointSink &operator=(const CheckpointSink &) = delete;
+
+    // Вызывается из потока решателя. serialize выполняется потоком записи и возвращает нагрузку;
+    // данные, которые она читает, решатель не меняет до ее завершения (снимок или неизменяемый объект)
+    void submit(std::function<std::string()> serialize)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = std::move(serialize);
+        }
+        wakeUp.notify_one();
+    }
+
+    // Ожидающей точки нет: поток записи уже взял последнюю отданную точку. Решатель с двумя буферами
+    // снимков может заполнить буфер, не отданный последним, - поток записи его больше не читает
+    bool ready() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !pending;
+    }
+
+    int getWrites() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return writes;
+    }
+
+    // Сообщение об ошибке последней записи (пусто, если записи удавались)
+    std::string getError() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return error;
+    }
+
+private:
+    void writerLoop()
+    {
+        while (true)
+        {
+            std::function<std::string()> serialize;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this]()
+                            { return pending || stopping; });
+                if (!pending)
+                {
+                    return;
+                }
+                serialize.swap(pending);
+            }
+            std::string message;
+            try
+            {
+                message = writeFile(serialize());
+            }
+            catch (const std::exception &e)
+            {
+                message = std::string("Unable to serialize checkpoint: ") + e.what();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            error = message;
+            writes += message.empty() ? 1 : 0;
+        }
+    }
+
+    std::string writeFile(const std::string &payload)
+    {
+        CheckpointHeader fileHeader = header;
+        fileHeader.payloadSize = payload.size();
+        fileHeader.payloadChecksum = jobFileChecksum(reinterpret_cast<const uint8_t *>(payload.data()), payload.size());
+        std::string temporary = path + ".tmp";
+        std::FILE *file = std::fopen(temporary.c_str(), "wb");
+        if (!file)
+        {
+            return "Unable to open file " + temporary;
+        }
+        // Без fsync rename может попасть на диск раньше данных, и после сбоя под именем точки окажется обрывок
+        bool written = std::fwrite(&fileHeader, sizeof(fileHeader), 1, file) == 1 &&
+                       std::fwrite(payload.data(), 1, payload.size(), file) == payload.size() &&
+                       std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+        if (std::fclose(file) != 0 || !written)
+        {
+            return "Unable to write file " + temporary;
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            return "Unable to rename " + temporary + " to " + path;
+        }
+        return "";
+    }
+
+    std::string path;
+    CheckpointHeader header{};
+    mutable std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::function<std::string()> pending; // Сериализация последней незаписанной точки (под mutex)
+    bool stopping = false;
+    int writes = 0;
+    std::string error;
+    std::thread writer;
+};
+
+// Расписание контрольных точек с ограничением накладных расходов: следующая точка не раньше чем через
+// interval и не раньше чем через maxOverheadFactor длительностей последней сериализации,
+// поэтому доля времени решателя на контрольные точки не превышает 1 / maxOverheadFactor
+class CheckpointTimer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr double maxOverheadFactor = 100.0;
+
+    explicit CheckpointTimer(double intervalSeconds = 10.0)
+        : interval(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(intervalSeconds))), next(Clock::now() + interval) {}
+
+    bool due(Clock::time_point now) const { return now >= next; }
+
+    // Отметка завершенной сериализации, начатой в started
+    void done(Clock::time_point started)
+    {
+        Clock::time_point now = Clock::now();
+        next = now + std::max(interval, std::chrono::duration_cast<Clock::duration>((now - started) * maxOverheadFactor));
+    }
+
+private:
+    Clock::duration interval;
+    Clock::time_point next;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,208 @@
+#ifndef DURATION_INDEX_H
+#define DURATION_INDEX_H
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// Индекс работ по длительностям для каждого процессора.
+// Длительность - uint8_t, поэтому у процессора не больше 256 корзин. Корзина (процессор, длительность) -
+// двусвязный список работ в общих массивах next / prev, а непустые корзины процессора отмечены
+// в 256-битной маске. Вставка и удаление работы стоят O(1), поиск работы процессора с длительностью,
+// ближайшей к заданной, - несколько битовых операций над маской.
+// Работа вставляется в хвост корзины, а closestJob берет голову. Работа, возвращенная откатом
+// отвергнутого хода, уходит в конец очереди, и следующий запрос предлагает другую работу той же длительности
+class DurationIndex
+{
+public:
+    static constexpr int numDurations = 256;
+
+    DurationIndex() = default;
+
+    void build(int numProcessors, const std::vector<uint8_t> &jobDurations, const std::vector<int> &assignment)
+    {
+        clear(numProcessors, jobDurations.size());
+        for (size_t job = 0; job < jobDurations.size(); ++job)
+        {
+            insert(assignment[job], static_cast<int>(job), jobDurations[job]);
+        }
+    }
+
+    // Построение с заданным порядком работ внутри корзин (order - результат bucketOrder).
+    // Порядок влияет на выбор работы в closestJob, поэтому восстанавливается для точного возобновления отжига
+    void build(int numProcessors, const std::vector<uint8_t> &jobDurations, const std::vector<int> &assignment, const std::vector<int> &order)
+    {
+        clear(numProcessors, jobDurations.size());
+        for (int job : order)
+        {
+            insert(assignment[job], job, jobDurations[job]);
+        }
+    }
+
+    // Все работы, перечисленные по корзинам (процессор, длительность) в порядке списков
+    std::vector<int> bucketOrder() const
+    {
+        std::vector<int> order;
+        order.reserve(next.size());
+        for (int head : heads)
+        {
+            for (int job = head; job >= 0; job = next[job])
+            {
+                order.push_back(job);
+            }
+        }
+        return order;
+    }
+
+    void insert(int processor, int job, uint8_t duration)
+    {
+        size_t bucket = bucketOf(processor, duration);
+        int tail = tails[bucket];
+        next[job] = -1;
+        prev[job] = tail;
+        if (tail >= 0)
+        {
+            next[tail] = job;
+        }
+        else
+        {
+            heads[bucket] = job;
+        }
+        tails[bucket] = job;
+        if (counts[bucket]++ == 0)
+        {
+            occupied[processor * maskWords + duration / 64] |= uint64_t(1) << (duration % 64);
+        }
+    }
+
+    void erase(int processor, int job, uint8_t duration)
+    {
+        size_t bucket = bucketOf(processor, duration);
+        if (prev[job] >= 0)
+        {
+            next[prev[job]] = next[job];
+        }
+        else
+        {
+            heads[bucket] = next[job];
+        }
+        if (next[job] >= 0)
+        {
+            prev[next[job]] = prev[job];
+        }
+        else
+        {
+            tails[bucket] = prev[job];
+        }
+        if (--counts[bucket] == 0)
+        {
+            occupied[processor * maskWords + duration / 64] &= ~(uint64_t(1) << (duration % 64));
+        }
+    }
+
+    // Количество работ процессора с данной длительностью
+    int count(int processor, int duration) const
+    {
+        return counts[bucketOf(processor, duration)];
+    }
+
+    // Работа процессора с длительностью, ближайшей к target (при равенстве - меньшая длительность),
+    // или -1, если процессор пуст. Из корзины берется работа, дольше всех стоящая в очереди
+    int closestJob(int processor, int target) const
+    {
+        int duration = closestDuration(processor, target);
+        return duration < 0 ? -1 : heads[bucketOf(processor, duration)];
+    }
+
+    // Ближайшая к target длительность среди работ процессора или -1, если процессор пуст
+    int closestDuration(int processor, int target) const
+    {
+        if (target < 0)
+        {
+            target = 0;
+        }
+        if (target >= numDurations)
+        {
+            target = numDurations - 1;
+        }
+        int below = highestAtMost(processor, target);
+        int above = lowestAtLeast(processor, target);
+        if (below < 0)
+        {
+            return above;
+        }
+        if (above < 0)
+        {
+            return below;
+        }
+        return target - below <= above - target ? below : above;
+    }
+
+private:
+    static constexpr int maskWords = numDurations / 64;
+
+    void clear(int numProcessors, size_t numJobs)
+    {
+        heads.assign(static_cast<size_t>(numProcessors) * numDurations, -1);
+        tails.assign(static_cast<size_t>(numProcessors) * numDurations, -1);
+        counts.assign(static_cast<size_t>(numProcessors) * numDurations, 0);
+        occupied.assign(static_cast<size_t>(numProcessors) * maskWords, 0);
+        next.assign(numJobs, -1);
+        prev.assign(numJobs, -1);
+    }
+
+    size_t bucketOf(int processor, int duration) const
+    {
+        return static_cast<size_t>(processor) * numDurations + duration;
+    }
+
+    // Наибольшая непустая длительность <= limit или -1
+    int highestAtMost(int processor, int limit) const
+    {
+        const uint64_t *mask = &occupied[processor * maskWords];
+        int word = limit / 64;
+        int bit = limit % 64;
+        uint64_t bits = mask[word] & (bit == 63 ? ~uint64_t(0) : (uint64_t(1) << (bit + 1)) - 1);
+        while (true)
+        {
+            if (bits != 0)
+            {
+                return word * 64 + 63 - std::countl_zero(bits);
+            }
+            if (--word < 0)
+            {
+                return -1;
+            }
+            bits = mask[word];
+        }
+    }
+
+    // Наименьшая непустая длительность >= limit или -1
+    int lowestAtLeast(int processor, int limit) const
+    {
+        const uint64_t *mask = &occupied[processor * maskWords];
+        int word = limit / 64;
+        uint64_t bits = mask[word] & (~uint64_t(0) << (limit % 64));
+        while (true)
+        {
+            if (bits != 0)
+            {
+                return word * 64 + std::countr_zero(bits);
+            }
+            if (++word == maskWords)
+            {
+                return -1;
+            }
+            bits = mask[word];
+        }
+    }
+
+    std::vector<int> heads;          // Первая работа корзины (процессор, длительность) или -1
+    std::vector<int> tails;          // Последняя работа корзины или -1
+    std::vector<int> counts;         // Размеры корзин
+    std::vector<uint64_t> occupied;  // Маски непустых корзин, maskWords слов на процессор
+    std::vector<int> next;           // Следующая работа той же корзины
+    std::vector<int> prev;           // Предыдущая работа той же корзины
+};
+
+#endif // DURATION_INDEX_H
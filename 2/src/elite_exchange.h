@@ -0,0 +1,61 @@
+#ifndef ELITE_EXCHANGE_H
+#define ELITE_EXCHANGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "annealing.h"
+
+// Общий слот элитного решения для островной модели отжига.
+// Опубликованный снимок неизменяем, поэтому острова читают его без блокировок
+// и копируют к себе только при смене эпохи
+class EliteExchange
+{
+public:
+    // Неизменяемый снимок элитного решения
+    struct Elite
+    {
+        std::shared_ptr<const Solution> solution;
+        double cost;
+        uint64_t epoch; // Номер публикации, растет с каждым улучшением
+    };
+
+    explicit EliteExchange(std::shared_ptr<const Solution> initial)
+        : slot(std::make_shared<const Elite>(Elite{initial, initial->getCost(), 0})) {}
+
+    // Публикация кандидата. Снимок заменяется, только если кандидат строго лучше текущего.
+    // Конкурентные публикации разрешаются через compare_exchange, без мьютекса.
+    // Возвращает эпоху опубликованного снимка или 0, если кандидат не принят
+    uint64_t publish(const std::shared_ptr<const Solution> &candidate, double cost)
+    {
+        std::shared_ptr<const Elite> current = slot.load(std::memory_order_acquire);
+        while (cost < current->cost)
+        {
+            auto next = std::make_shared<const Elite>(Elite{candidate, cost, current->epoch + 1});
+            if (slot.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                // Счетчик эпох только растет, даже если публикации завершились не по порядку
+                uint64_t seen = epochCounter.load(std::memory_order_relaxed);
+                while (seen < next->epoch && !epochCounter.compare_exchange_weak(seen, next->epoch, std::memory_order_release, std::memory_order_relaxed))
+                {
+                }
+                return next->epoch;
+            }
+        }
+        return 0;
+    }
+
+    // Дешевая проверка, появилось ли новое элитное решение
+    uint64_t epoch() const { return epochCounter.load(std::memory_order_acquire); }
+
+    std::shared_ptr<const Elite> snapshot() const { return slot.load(std::memory_order_acquire); }
+
+    double bestCost() const { return snapshot()->cost; }
+
+private:
+    std::atomic<std::shared_ptr<const Elite>> slot;
+    std::atomic<uint64_t> epochCounter{0};
+};
+
+#endif // ELITE_EXCHANGE_H
@@ -0,0 +1,201 @@
+#ifndef INITIAL_SOLUTION_H
+#define INITIAL_SOLUTION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+
+// Построители начального назначения работ процессорам: assignment[job] -> processor
+
+// Случайное назначение: каждая работа на равновероятный процессор
+inline std::vector<int> randomAssignment(const std::vector<uint8_t> &jobDurations, int numProcessors, Xoshiro256 &rng)
+{
+    std::vector<int> assignment(jobDurations.size());
+    for (size_t i = 0; i < jobDurations.size(); ++i)
+    {
+        assignment[i] = rng.uniformInt(numProcessors);
+    }
+    return assignment;
+}
+
+// Порядок работ по убыванию длительности. Длительностей не больше 256,
+// поэтому сортировка подсчетом за O(N + 256)
+inline std::vector<int> jobsByDecreasingDuration(const std::vector<uint8_t> &jobDurations)
+{
+    std::vector<int> start(257, 0);
+    for (uint8_t duration : jobDurations)
+    {
+        start[255 - duration + 1]++;
+    }
+    for (int d = 1; d <= 256; ++d)
+    {
+        start[d] += start[d - 1];
+    }
+    std::vector<int> order(jobDurations.size());
+    for (size_t i = 0; i < jobDurations.size(); ++i)
+    {
+        order[start[255 - jobDurations[i]]++] = static_cast<int>(i);
+    }
+    return order;
+}
+
+// Жадный алгоритм LPT (Longest Processing Time): работы по убыванию длительности,
+// каждая на процессор с минимальной текущей нагрузкой (куча минимумов по нагрузке)
+inline std::vector<int> lptAssignment(const std::vector<uint8_t> &jobDurations, int numProcessors)
+{
+    using Entry = std::pair<long long, int>; // (нагрузка, процессор)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> loads;
+    for (int p = 0; p < numProcessors; ++p)
+    {
+        loads.push({0, p});
+    }
+    std::vector<int> assignment(jobDurations.size());
+    for (int job : jobsByDecreasingDuration(jobDurations))
+    {
+        auto [load, processor] = loads.top();
+        loads.pop();
+        assignment[job] = processor;
+        loads.push({load + jobDurations[job], processor});
+    }
+    return assignment;
+}
+
+// Многопутевой метод разностей Кармаркара-Карпа.
+// Каждое частичное решение - разбиение на numProcessors подмножеств; на каждом шаге два разбиения
+// с наибольшим разбросом (max - min) объединяются так, что самое тяжелое подмножество одного
+// складывается с самым легким подмножеством другого. Хранятся только непустые подмножества,
+// а списки работ - односвязные списки в общем массиве, поэтому память O(N + числа непустых подмножеств)
+inline std::vector<int> karmarkarKarpAssignment(const std::vector<uint8_t> &jobDurations, int numProcessors)
+{
+    struct Subset
+    {
+        long long sum;
+        int head; // Первая работа подмножества
+        int tail; // Последняя работа подмножества
+    };
+    // Непустые подмножества разбиения по убыванию суммы; остальные подмножества пусты
+    using Partition = std::vector<Subset>;
+
+    int numJobs = static_cast<int>(jobDurations.size());
+    std::vector<int> assignment(numJobs, 0);
+    if (numJobs == 0)
+    {
+        return assignment;
+    }
+    std::vector<int> next(numJobs, -1);
+    std::vector<Partition> partitions(numJobs);
+    for (int i = 0; i < numJobs; ++i)
+    {
+        partitions[i].push_back({jobDurations[i], i, i});
+    }
+
+    auto spread = [numProcessors](const Partition &partition)
+    {
+        long long smallest = static_cast<int>(partition.size()) < numProcessors ? 0 : partition.back().sum;
+        return static_cast<int>(partition.front().sum - smallest);
+    };
+
+    // Разброс объединения не превышает большего из разбросов объединяемых разбиений,
+    // поэтому все разбросы лежат в [0, 255]. Вместо кучи достаточно очереди
+    // с корзинами по значению разброса: вставка за O(1), извлечение за O(256) в худшем случае
+    std::vector<std::vector<int>> buckets(256);
+    for (int i = 0; i < numJobs; ++i)
+    {
+        buckets[jobDurations[i]].push_back(i);
+    }
+    int largestSpread = 255;
+    auto popLargest = [&]()
+    {
+        while (buckets[largestSpread].empty())
+        {
+            --largestSpread;
+        }
+        int index = buckets[largestSpread].back();
+        buckets[largestSpread].pop_back();
+        return index;
+    };
+
+    auto heavierFirst = [](const Subset &x, const Subset &y)
+    { return x.sum > y.sum; };
+    Partition changed;
+    Partition merged;
+    int target = 0; // При одной работе цикл не выполняется и итог - разбиение 0
+    for (int remaining = numJobs; remaining > 1; --remaining)
+    {
+        target = popLargest();
+        int source = popLargest();
+        Partition &a = partitions[target];
+        Partition &b = partitions[source];
+        int sizeA = static_cast<int>(a.size());
+        int sizeB = static_cast<int>(b.size());
+
+        // Позиция i разбиения a (по убыванию) складывается с позицией P - 1 - i разбиения b.
+        // Позиции i < P - sizeB получают пустое подмножество b и не меняются (sizeB <= P)
+        int firstChanged = numProcessors - sizeB;
+        changed.clear();
+        for (int i = firstChanged; i < numProcessors; ++i)
+        {
+            const Subset &fromB = b[numProcessors - 1 - i];
+            if (i < sizeA)
+            {
+                Subset combined = a[i];
+                combined.sum += fromB.sum;
+                next[combined.tail] = fromB.head;
+                combined.tail = fromB.tail;
+                changed.push_back(combined);
+            }
+            else
+            {
+                changed.push_back(fromB);
+            }
+        }
+        std::sort(changed.begin(), changed.end(), heavierFirst);
+
+        merged.clear();
+        std::merge(a.begin(), a.begin() + std::min(sizeA, firstChanged), changed.begin(), changed.end(), std::back_inserter(merged), heavierFirst);
+        a.swap(merged);
+        Partition().swap(b);
+        int mergedSpread = spread(a);
+        buckets[mergedSpread].push_back(target);
+        largestSpread = std::max(largestSpread, mergedSpread);
+    }
+
+    // Подмножество s итогового разбиения назначается процессору s
+    const Partition &result = partitions[target];
+    for (size_t s = 0; s < result.size(); ++s)
+    {
+        for (int job = result[s].head; job != -1; job = next[job])
+        {
+            assignment[job] = static_cast<int>(s);
+        }
+    }
+    return assignment;
+}
+
+// Начальное назначение по имени метода из командной строки
+inline std::vector<int> buildInitialAssignment(const std::string &method, const std::vector<uint8_t> &jobDurations, int numProcessors, Xoshiro256 &rng)
+{
+    if (method == "random")
+    {
+        return randomAssignment(jobDurations, numProcessors, rng);
+    }
+    if (method == "lpt")
+    {
+        return lptAssignment(jobDurations, numProcessors);
+    }
+    if (method == "kk")
+    {
+        return karmarkarKarpAssignment(jobDurations, numProcessors);
+    }
+    throw std::invalid_argument("Invalid initial solution method '" + method + "'. Available methods: random, lpt, kk");
+}
+
+#endif // INITIAL_SOLUTION_H
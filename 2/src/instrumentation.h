@@ -0,0 +1,185 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// Инструментирование цикла отжига, включаемое при компиляции флагом -DANNEALING_INSTRUMENTATION.
+//
+//   ANNEALING_COUNT(counter)            - увеличить счетчик потока
+//   ANNEALING_TIMED(phase, expression)  - вычислить выражение, прибавив его время к фазе
+//   ANNEALING_REPORT(stream)            - напечатать отчет JSON по всем потокам
+//
+// Счетчики и таймеры каждого потока лежат в его собственной строке кэша и меняются без атомарных
+// операций; суммирование выполняется только при печати отчета, когда потоки отжига уже остановлены.
+// Без флага макросы раскрываются в само выражение или в пустую инструкцию, и код отжига не меняется
+
+#ifdef ANNEALING_INSTRUMENTATION
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+enum class InstrumentationCounter
+{
+    Iterations,    // Шаги отжига
+    Improvements,  // Принятые улучшения лучшей стоимости
+    AcceptedWorse, // Ухудшения, принятые правилом Метрополиса
+    Rejected,      // Отвергнутые и откаченные ходы
+    Clones,        // Полные копии решения
+    Count
+};
+
+enum class InstrumentationPhase
+{
+    Mutate,   // Ход окрестности (включая генератор и выбор хода)
+    Cost,     // Вычисление стоимости
+    Accept,   // Правило Метрополиса (включая генератор)
+    Commit,   // Фиксация хода
+    Rollback, // Откат хода
+    Clone,    // Копирование решения
+    Count
+};
+
+inline const char *instrumentationName(InstrumentationCounter counter)
+{
+    static const char *names[] = {"iterations", "improvements", "accepted_worse", "rejected", "clones"};
+    return names[static_cast<int>(counter)];
+}
+
+inline const char *instrumentationName(InstrumentationPhase phase)
+{
+    static const char *names[] = {"mutate", "cost", "accept", "commit", "rollback", "clone"};
+    return names[static_cast<int>(phase)];
+}
+
+// Такты процессора (rdtsc) на x86, наносекунды steady_clock на остальных архитектурах
+inline uint64_t readCycleCounter()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Счетчики одного потока на отдельных строках кэша
+struct alignas(64) InstrumentationSlot
+{
+    static constexpr int counterCount = static_cast<int>(InstrumentationCounter::Count);
+    static constexpr int phaseCount = static_cast<int>(InstrumentationPhase::Count);
+
+    uint64_t counts[counterCount] = {};
+    uint64_t calls[phaseCount] = {};
+    uint64_t cycles[phaseCount] = {};
+};
+
+// Реестр слотов потоков. Мьютекс берется только при первом обращении потока и при печати отчета
+class InstrumentationRegistry
+{
+public:
+    InstrumentationSlot &acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return slots.emplace_back();
+    }
+
+    void report(std::ostream &out)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        InstrumentationSlot total;
+        out << "{\"timer\":\"" << timerName() << "\",\"threads\":[";
+        for (size_t t = 0; t < slots.size(); ++t)
+        {
+            out << (t > 0 ? "," : "");
+            writeSlot(out, slots[t]);
+            for (int i = 0; i < InstrumentationSlot::counterCount; ++i)
+            {
+                total.counts[i] += slots[t].counts[i];
+            }
+            for (int i = 0; i < InstrumentationSlot::phaseCount; ++i)
+            {
+                total.calls[i] += slots[t].calls[i];
+                total.cycles[i] += slots[t].cycles[i];
+            }
+        }
+        out << "],\"total\":";
+        writeSlot(out, total);
+        out << "}" << std::endl;
+    }
+
+private:
+    static const char *timerName()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return "rdtsc";
+#else
+        return "nanoseconds";
+#endif
+    }
+
+    static void writeSlot(std::ostream &out, const InstrumentationSlot &slot)
+    {
+        out << "{\"counters\":{";
+        for (int i = 0; i < InstrumentationSlot::counterCount; ++i)
+        {
+            out << (i > 0 ? "," : "") << "\"" << instrumentationName(static_cast<InstrumentationCounter>(i)) << "\":" << slot.counts[i];
+        }
+        out << "},\"phases\":{";
+        for (int i = 0; i < InstrumentationSlot::phaseCount; ++i)
+        {
+            double average = slot.calls[i] > 0 ? static_cast<double>(slot.cycles[i]) / slot.calls[i] : 0.0;
+            out << (i > 0 ? "," : "") << "\"" << instrumentationName(static_cast<InstrumentationPhase>(i)) << "\":{\"calls\":" << slot.calls[i]
+                << ",\"cycles\":" << slot.cycles[i] << ",\"cycles_per_call\":" << average << "}";
+        }
+        out << "}}";
+    }
+
+    std::mutex mutex;
+    std::deque<InstrumentationSlot> slots; // deque не перемещает элементы при добавлении
+};
+
+inline InstrumentationRegistry instrumentationRegistry;
+
+inline InstrumentationSlot &instrumentationSlot()
+{
+    thread_local InstrumentationSlot &slot = instrumentationRegistry.acquire();
+    return slot;
+}
+
+// Вычисление выражения с учетом его времени в фазе; результат выражения возвращается без изменений
+template <typename Function>
+inline decltype(auto) instrumentedCall(InstrumentationPhase phase, Function &&function)
+{
+    InstrumentationSlot &slot = instrumentationSlot();
+    uint64_t start = readCycleCounter();
+    struct Stop
+    {
+        InstrumentationSlot &slot;
+        int phase;
+        uint64_t start;
+        ~Stop()
+        {
+            slot.calls[phase]++;
+            slot.cycles[phase] += readCycleCounter() - start;
+        }
+    } stop{slot, static_cast<int>(phase), start};
+    return function();
+}
+
+#define ANNEALING_COUNT(counter) (instrumentationSlot().counts[static_cast<int>(InstrumentationCounter::counter)]++)
+#define ANNEALING_TIMED(phase, expression) (instrumentedCall(InstrumentationPhase::phase, [&]() -> decltype(auto) { return expression; }))
+#define ANNEALING_REPORT(stream) (instrumentationRegistry.report(stream))
+
+#else
+
+#define ANNEALING_COUNT(counter) ((void)0)
+#define ANNEALING_TIMED(phase, expression) (expression)
+#define ANNEALING_REPORT(stream) ((void)0)
+
+#endif // ANNEALING_INSTRUMENTATION
+
+#endif // INSTRUMENTATION_H
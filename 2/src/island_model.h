@@ -0,0 +1,482 @@
+#ifndef ISLAND_MODEL_H
+#define ISLAND_MODEL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "annealing.h"
+#include "checkpoint.h"
+#include "elite_exchange.h"
+#include "instrumentation.h"
+#include "progress.h"
+#include "random.h"
+#include "scheduling.h"
+#include "thread_pool.h"
+
+// Типы решения, мутации и закона охлаждения - параметры шаблона, чтобы цикл отжига обходился без виртуальных вызовов
+template <typename SolutionT, typename MutationT, typename CoolingT>
+class ParallelSimulatedAnnealing
+{
+public:
+    // Цепочка отжига работает на месте над решением острова
+    // Генератор принадлежит острову и переживает его цепочки
+    // Таблица температур общая для всех островов и раундов
+    ParallelSimulatedAnnealing(std::shared_ptr<SolutionT> solution, MutationT *mutationOperation, const TemperatureTable<CoolingT> *temperatures, double initialTemperature, int maxIterations, int maxNoImprovementCount, Xoshiro256 &rng)
+        : workingSolution(std::move(solution)), mutationOperation(mutationOperation), temperatures(temperatures), temperature(initialTemperature), maxIterations(maxIterations), maxNoImprovementCount(maxNoImprovementCount), rng(rng) {}
+
+    // Срок прогона: цепочка прерывается, проверяя часы раз в deadlineCheckInterval итераций
+    void setDeadline(std::chrono::steady_clock::time_point value)
+    {
+        deadline = value;
+        timeLimited = true;
+    }
+
+    void run()
+    {
+        int iteration = 0;
+        double bestCost = workingSolution->getCost(); // Изначальная стоимость решения
+        int noImprovementCount = 0;                   // Счетчик количества итераций без улучшения
+        workingSolution->markBest();
+
+        // Нейтральные ходы (обмен работ равной длительности) принимаются всегда и сбрасывают счетчик,
+        // поэтому длина цепочки дополнительно ограничена длиной таблицы температур
+        while (iteration < maxIterations && noImprovementCount < maxNoImprovementCount)
+        {
+            if (timeLimited && iteration % deadlineCheckInterval == 0 && std::chrono::steady_clock::now() >= deadline)
+            {
+                break;
+            }
+            // Применяем мутацию к решению на месте, без копирования всего расписания
+            ANNEALING_COUNT(Iterations);
+            ANNEALING_TIMED(Mutate, mutationOperation->mutate(*workingSolution, rng));
+            double currentCost = ANNEALING_TIMED(Cost, workingSolution->getCost()); // Стоимость мутированного решения
+
+            if (currentCost < bestCost)
+            {
+                // Если новое решение лучше, фиксируем мутацию и запоминаем его как лучшее
+                ANNEALING_COUNT(Improvements);
+                bestCost = currentCost;
+                noImprovementCount = 0;
+                ANNEALING_TIMED(Commit, workingSolution->commit());
+                workingSolution->markBest();
+            }
+            else
+            {
+                // Если решение хуже, то принимаем его с некоторой вероятностью (правило Метрополиса)
+                if (ANNEALING_TIMED(Accept, metropolisAccept(currentCost - bestCost, temperature, rng)))
+                {
+                    // Принять ухудшающее решение и зафиксировать мутацию
+                    ANNEALING_COUNT(AcceptedWorse);
+                    noImprovementCount = 0;
+                    ANNEALING_TIMED(Commit, workingSolution->commit());
+                }
+                else
+                {
+                    // Если решение не принято, откатываем мутацию и увеличиваем счетчик итераций без улучшений
+                    ANNEALING_COUNT(Rejected);
+                    ANNEALING_TIMED(Rollback, workingSolution->rollback());
+                    noImprovementCount++;
+                }
+            }
+            // Обновляем температуру согласно закону понижения температуры
+            iteration++;
+            temperature = temperatures->at(iteration, temperature);
+        }
+        iterations = iteration;
+        // Цепочка заканчивается в текущем состоянии; возвращаем остров к лучшему решению цепочки
+        workingSolution->restoreBest();
+        localBestSolution = workingSolution;
+    }
+
+    std::shared_ptr<SolutionT> getLocalBestSolution() const
+    {
+        return localBestSolution;
+    }
+
+    long long getIterations() const
+    {
+        return iterations;
+    }
+
+private:
+    static constexpr int deadlineCheckInterval = 1024;
+
+    std::shared_ptr<SolutionT> workingSolution; // Решение острова: мутируется на месте и в конце возвращается к лучшему
+    std::shared_ptr<SolutionT> localBestSolution;
+    MutationT *mutationOperation;
+    const TemperatureTable<CoolingT> *temperatures;
+    double temperature;
+    int maxIterations;
+    int maxNoImprovementCount;
+    Xoshiro256 &rng;
+    long long iterations = 0;
+    bool timeLimited = false;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+// Состояние островной модели, восстановленное из контрольной точки
+struct IslandModelCheckpoint
+{
+    uint64_t masterSeed = 0;
+    uint64_t seedGeneration = 0; // Номер поколения потоков генераторов островов
+    long long iterations = 0;
+    long long rounds = 0;
+    double seconds = 0;
+};
+
+// Параметры островной модели
+struct IslandModelOptions
+{
+    int numThreads = 1;                   // Количество островов и потоков пула
+    int maxNoImprovementCount = 100;      // Итерации цепочки без улучшения до ее останова
+    int maxGlobalNoImprovementCount = 10; // Раунды без улучшения элитного решения (на поток) до останова
+    double initialTemperature = 100.0;
+    int temperatureTableSize = 100000;    // Длина таблицы температур и максимальная длина цепочки
+    uint64_t masterSeed = 0;              // Острова получают цепочки 1..numThreads (см. islandChainId)
+    bool timeLimited = false;             // Раунды продолжаются до deadline независимо от застоя
+    bool synchronousRounds = false;       // Раунды всех островов с общим слиянием (воспроизводимый прогон)
+    bool pinThreads = false;              // Закрепление потоков пула за ядрами маски процесса
+    std::chrono::steady_clock::time_point deadline;
+    ProgressSink *progress = nullptr;     // Приемник публикаций элитного решения (может отсутствовать)
+    double targetCost = -1;               // Стоимость для измерения времени достижения (< 0 - не измеряется)
+    CheckpointSink *checkpoints = nullptr; // Приемник контрольных точек (может отсутствовать)
+    double checkpointInterval = 10.0;     // Секунды между контрольными точками
+    IslandModelCheckpoint resumed;        // Счетчики и поколение генераторов прерванного прогона
+};
+
+// Номер цепочки генератора острова island; каждое поколение (возобновление из контрольной точки)
+// получает следующие numThreads номеров. Цепочка 0 зарезервирована за начальным решением
+inline uint64_t islandChainId(int numThreads, uint64_t seedGeneration, int island)
+{
+    return 1 + island + static_cast<uint64_t>(numThreads) * seedGeneration;
+}
+
+// Чтение контрольной точки островной модели: элитное решение загружается в solution
+inline IslandModelCheckpoint loadIslandModelCheckpoint(CheckpointReader &reader, SchedulingSolution &solution)
+{
+    IslandModelCheckpoint state;
+    state.masterSeed = reader.get<uint64_t>();
+    state.seedGeneration = reader.get<uint64_t>();
+    state.iterations = reader.get<long long>();
+    state.rounds = reader.get<long long>();
+    state.seconds = reader.get<double>();
+    double eliteCost = reader.get<double>();
+    solution.loadState(reader);
+    if (!reader.atEnd())
+    {
+        throw std::runtime_error("Checkpoint has unexpected trailing data");
+    }
+    if (solution.getCost() != eliteCost)
+    {
+        throw std::runtime_error("Checkpoint does not match the objective or processor model of this run");
+    }
+    return state;
+}
+
+// Итог прогона островной модели
+struct IslandModelResult
+{
+    std::shared_ptr<const Solution> bestSolution;
+    double bestCost = 0;
+    long long iterations = 0;
+    long long rounds = 0;     // Раунды с учетом восстановленных из контрольной точки
+    long long runRounds = 0;  // Раунды этого запуска: по ним усредняются времена раундов
+    double seconds = 0;      // Время работы модели без подготовки входных данных
+    double timeToTarget = -1; // Секунды до публикации решения не хуже targetCost или -1
+    // Суммарные времена раундов этого запуска: отжиг, ожидание в очереди пула и обмен с элитным слотом
+    double annealingMicroseconds = 0;
+    double queueMicroseconds = 0;
+    double exchangeMicroseconds = 0;
+    std::string pinningError; // Ошибка закрепления потоков (пусто, если закрепление удалось или не запрашивалось)
+};
+
+// Островная модель: у каждого острова свое решение и свой генератор на весь прогон.
+// Раунд острова (одна цепочка отжига и обмен с элитным слотом) - задача пула потоков;
+// в конце раунда остров ставит в пул свой следующий раунд, поэтому потоки создаются один раз.
+// После каждой цепочки остров публикует свое решение в общий слот и забирает
+// элитное решение, если оно лучше. Останов - когда ни один остров не улучшал
+// элитное решение maxGlobalNoImprovementCount раундов в пересчете на поток.
+//
+// С synchronousRounds острова проходят раунды вместе: все цепочки раунда выполняются в пуле, затем
+// один поток сливает их результаты в порядке номеров островов - лучшее решение (по стоимости, при
+// равенстве - с меньшим номером острова) публикуется, а острова хуже элитного решения начинают
+// следующий раунд с его копии. Цепочки не прерываются по сроку, он проверяется между раундами.
+// Поэтому при заданном masterSeed и без срока результат не зависит от порядка завершения потоков
+// и от их числа в машине; ценой служит простой островов, закончивших раунд раньше других.
+//
+// Контрольная точка сохраняет элитное решение и общие счетчики; ее записывает остров, завершивший
+// раунд, когда подошел срок. Состояние островов в точку не входит: при возобновлении все острова
+// начинают с элитного решения с новыми потоками генераторов (следующее поколение seedGeneration),
+// поэтому возобновленный прогон не повторяет прерванный побитово - порядок обменов между островами
+// и так зависит от планирования потоков
+template <typename CoolingT>
+IslandModelResult runIslandModel(std::shared_ptr<SchedulingSolution> initialSolution, const SchedulingMutation &mutationPrototype, const CoolingT &coolingSchedule, const IslandModelOptions &options)
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    int numThreads = options.numThreads;
+    uint64_t seedGeneration = options.resumed.seedGeneration;
+
+    // Каждая цепочка начинает с initialTemperature, поэтому одна таблица обслуживает все цепочки
+    TemperatureTable<CoolingT> temperatures(coolingSchedule, options.initialTemperature, options.temperatureTableSize);
+    EliteExchange exchange(initialSolution);
+
+    // Состояние острова занимает отдельные строки кэша: генератор меняется на каждой итерации,
+    // и соседние острова не должны делить с ним строку. Счетчики тоже принадлежат острову
+    // и складываются только после завершения, поэтому на горячем пути нет общих изменяемых данных
+    struct alignas(64) Island
+    {
+        std::shared_ptr<SchedulingSolution> solution;
+        Xoshiro256 rng;
+        SchedulingMutation mutation; // Мутация хранит статистику выбора ходов, поэтому у острова своя копия
+        uint64_t seenEpoch = 0;
+        bool adoptElite = false; // Синхронные раунды: начать следующий раунд с копии элитного решения
+        double roundCost = 0;    // Синхронные раунды: стоимость решения острова после раунда
+        long long iterations = 0;
+        long long rounds = 0;
+        // Накладные расходы раунда: ожидание в очереди пула и обмен с элитным слотом.
+        // При числе островов больше числа ядер ожидание в очереди включает чужие раунды
+        long long queueNanoseconds = 0;
+        long long exchangeNanoseconds = 0;
+        long long annealingNanoseconds = 0;
+    };
+    int maxStagnantRounds = options.maxGlobalNoImprovementCount * numThreads;
+    std::atomic<int> stagnantRounds{0};
+    std::atomic<long long> targetNanoseconds{-1};
+    auto checkTarget = [&](double cost)
+    {
+        long long none = -1;
+        if (options.targetCost >= 0 && cost <= options.targetCost && targetNanoseconds.load(std::memory_order_relaxed) < 0)
+        {
+            targetNanoseconds.compare_exchange_strong(none, std::chrono::nanoseconds(Clock::now() - start).count());
+        }
+    };
+    if (options.progress)
+    {
+        options.progress->record(0, 0, exchange.bestCost());
+    }
+    checkTarget(exchange.bestCost());
+
+    // Общие счетчики для контрольных точек; острова добавляют в них итоги раунда
+    std::atomic<long long> totalIterations{options.resumed.iterations};
+    std::atomic<long long> totalRounds{options.resumed.rounds};
+    std::mutex checkpointMutex;
+    CheckpointTimer checkpointTimer(options.checkpointInterval);
+    // Опубликованное элитное решение не меняется, поэтому его сериализует поток записи без копирования
+    auto saveCheckpoint = [&](Clock::time_point now)
+    {
+        auto elite = exchange.snapshot();
+        CheckpointWriter writer;
+        writer.put(options.masterSeed);
+        writer.put(seedGeneration + 1);
+        writer.put(totalIterations.load(std::memory_order_relaxed));
+        writer.put(totalRounds.load(std::memory_order_relaxed));
+        writer.put(options.resumed.seconds + std::chrono::duration<double>(now - start).count());
+        writer.put(elite->cost);
+        options.checkpoints->submit([prefix = writer.release(), elite]()
+                                    {
+                                        CheckpointWriter payload(prefix);
+                                        elite->solution->saveState(payload);
+                                        return payload.release(); });
+        checkpointTimer.done(now);
+    };
+
+    ThreadPool pool(numThreads, options.pinThreads);
+    std::vector<Island> islands(numThreads);
+    for (int i = 0; i < numThreads; ++i)
+    {
+        islands[i].rng.seed(deriveSeed(options.masterSeed, islandChainId(numThreads, seedGeneration, i)));
+        islands[i].mutation = mutationPrototype;
+    }
+
+    // Цепочка отжига острова с учетом ее итераций в счетчиках
+    auto annealIsland = [&](int i)
+    {
+        Island &island = islands[i];
+        // Решение острова копируется в рабочем потоке, который выполняет этот раунд, поэтому страницы
+        // при первом касании выделяются на узле NUMA, где этот поток работает в момент копирования.
+        // Известен только поток, а не ядро или узел: узел фиксирован лишь при закреплении потоков
+        // (pinThreads), и даже тогда раунды острова могут быть украдены другим потоком пула
+        if (!island.solution || island.adoptElite)
+        {
+            auto elite = exchange.snapshot();
+            island.seenEpoch = elite->epoch;
+            island.adoptElite = false;
+            // В слот публикуются только решения задачи планирования
+            ANNEALING_COUNT(Clones);
+            island.solution = std::static_pointer_cast<SchedulingSolution>(ANNEALING_TIMED(Clone, elite->solution->clone()));
+        }
+
+        ParallelSimulatedAnnealing sa(island.solution, &island.mutation, &temperatures, options.initialTemperature, options.temperatureTableSize, options.maxNoImprovementCount, island.rng);
+        if (options.timeLimited && !options.synchronousRounds)
+        {
+            sa.setDeadline(options.deadline);
+        }
+        sa.run();
+        island.iterations += sa.getIterations();
+        island.rounds++;
+        totalIterations.fetch_add(sa.getIterations(), std::memory_order_relaxed);
+        totalRounds.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    std::function<void(int, Clock::time_point)> runRound = [&](int i, Clock::time_point submitted)
+    {
+        Island &island = islands[i];
+        auto roundStart = Clock::now();
+        annealIsland(i);
+        auto annealingEnd = Clock::now();
+
+        // Копия решения делается только если оно действительно лучше элитного
+        double cost = island.solution->getCost();
+        uint64_t published = cost < exchange.bestCost() ? (ANNEALING_COUNT(Clones), exchange.publish(ANNEALING_TIMED(Clone, island.solution->clone()), cost)) : 0;
+        if (published != 0)
+        {
+            stagnantRounds.store(0, std::memory_order_relaxed);
+            // Своя эпоха, а не текущая: более новое решение другого острова еще не принято
+            island.seenEpoch = published;
+            if (options.progress)
+            {
+                options.progress->record(1 + i, island.iterations, cost);
+            }
+            checkTarget(cost);
+        }
+        else
+        {
+            stagnantRounds.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Забираем элитное решение другого острова, если оно лучше своего
+        if (exchange.epoch() != island.seenEpoch)
+        {
+            auto elite = exchange.snapshot();
+            island.seenEpoch = elite->epoch;
+            if (elite->cost < cost)
+            {
+                ANNEALING_COUNT(Clones);
+                island.solution = std::static_pointer_cast<SchedulingSolution>(ANNEALING_TIMED(Clone, elite->solution->clone()));
+            }
+        }
+
+        auto roundEnd = Clock::now();
+        island.queueNanoseconds += std::chrono::nanoseconds(roundStart - submitted).count();
+        island.exchangeNanoseconds += std::chrono::nanoseconds(roundEnd - annealingEnd).count();
+        island.annealingNanoseconds += std::chrono::nanoseconds(annealingEnd - roundStart).count();
+
+        // Точку записывает один остров; остальные не ждут его и продолжают раунды
+        if (options.checkpoints && checkpointMutex.try_lock())
+        {
+            std::lock_guard<std::mutex> lock(checkpointMutex, std::adopt_lock);
+            Clock::time_point now = Clock::now();
+            if (checkpointTimer.due(now))
+            {
+                saveCheckpoint(now);
+            }
+        }
+
+        bool more = options.timeLimited ? Clock::now() < options.deadline : stagnantRounds.load(std::memory_order_relaxed) < maxStagnantRounds;
+        if (more)
+        {
+            pool.post([&runRound, i, next = Clock::now()]()
+                      { runRound(i, next); });
+        }
+    };
+
+    // Синхронный раунд острова: только цепочка, слияние выполняет вызывающий поток
+    auto runSynchronousRound = [&](int i, Clock::time_point submitted)
+    {
+        Island &island = islands[i];
+        auto roundStart = Clock::now();
+        annealIsland(i);
+        island.roundCost = island.solution->getCost();
+        island.queueNanoseconds += std::chrono::nanoseconds(roundStart - submitted).count();
+        island.annealingNanoseconds += std::chrono::nanoseconds(Clock::now() - roundStart).count();
+    };
+
+    if (options.synchronousRounds)
+    {
+        bool more = true;
+        while (more)
+        {
+            for (int i = 0; i < numThreads; ++i)
+            {
+                pool.post([&runSynchronousRound, i, submitted = Clock::now()]()
+                          { runSynchronousRound(i, submitted); });
+            }
+            pool.wait();
+
+            // Слияние в порядке номеров островов, независимо от порядка завершения цепочек
+            auto mergeStart = Clock::now();
+            int best = 0;
+            for (int i = 1; i < numThreads; ++i)
+            {
+                best = islands[i].roundCost < islands[best].roundCost ? i : best;
+            }
+            double cost = islands[best].roundCost;
+            if (cost < exchange.bestCost() && (ANNEALING_COUNT(Clones), exchange.publish(ANNEALING_TIMED(Clone, islands[best].solution->clone()), cost) != 0))
+            {
+                stagnantRounds.store(0, std::memory_order_relaxed);
+                if (options.progress)
+                {
+                    options.progress->record(1 + best, islands[best].iterations, cost);
+                }
+                checkTarget(cost);
+            }
+            else
+            {
+                stagnantRounds.fetch_add(numThreads, std::memory_order_relaxed);
+            }
+            for (Island &island : islands)
+            {
+                island.adoptElite = exchange.bestCost() < island.roundCost;
+            }
+            Clock::time_point now = Clock::now();
+            if (options.checkpoints && checkpointTimer.due(now))
+            {
+                saveCheckpoint(now);
+            }
+            for (Island &island : islands)
+            {
+                island.exchangeNanoseconds += std::chrono::nanoseconds(Clock::now() - mergeStart).count();
+            }
+            more = options.timeLimited ? Clock::now() < options.deadline : stagnantRounds.load(std::memory_order_relaxed) < maxStagnantRounds;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < numThreads; ++i)
+        {
+            pool.post([&runRound, i, submitted = Clock::now()]()
+                      { runRound(i, submitted); });
+        }
+        pool.wait();
+    }
+
+    IslandModelResult result;
+    result.iterations = options.resumed.iterations;
+    result.rounds = options.resumed.rounds;
+    result.seconds = options.resumed.seconds + std::chrono::duration<double>(Clock::now() - start).count();
+    auto elite = exchange.snapshot();
+    result.bestSolution = elite->solution;
+    result.pinningError = pool.getPinningError();
+    result.bestCost = elite->cost;
+    for (const Island &island : islands)
+    {
+        result.iterations += island.iterations;
+        result.runRounds += island.rounds;
+        result.annealingMicroseconds += island.annealingNanoseconds / 1000.0;
+        result.queueMicroseconds += island.queueNanoseconds / 1000.0;
+        result.exchangeMicroseconds += island.exchangeNanoseconds / 1000.0;
+    }
+    result.rounds += result.runRounds;
+    long long targetTime = targetNanoseconds.load();
+    result.timeToTarget = targetTime >= 0 ? targetTime / 1e9 : -1;
+    return result;
+}
+
+#endif // ISLAND_MODEL_H
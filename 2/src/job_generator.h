@@ -0,0 +1,217 @@
+#ifndef JOB_GENERATOR_H
+#define JOB_GENERATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "random.h"
+
+// Дискретное распределение длительностей на отрезке [minDuration, maxDuration].
+// Все законы сводятся к таблице весов не длиннее 255 значений, из которой выборка делается
+// методом псевдонимов (Vose) за O(1): одно равномерное целое и одно сравнение
+class DurationDistribution
+{
+public:
+    // weights[k] - вес длительности minDuration + k
+    DurationDistribution(int minDuration, const std::vector<double> &weights)
+        : minDuration(minDuration), probability(weights.size()), alias(weights.size())
+    {
+        int size = static_cast<int>(weights.size());
+        double total = 0;
+        for (double weight : weights)
+        {
+            total += weight;
+        }
+        if (size == 0 || !(total > 0))
+        {
+            throw std::invalid_argument("Duration distribution has no positive weights");
+        }
+
+        std::vector<double> scaled(size);
+        std::vector<int> small;
+        std::vector<int> large;
+        for (int k = 0; k < size; ++k)
+        {
+            scaled[k] = weights[k] * size / total;
+            (scaled[k] < 1.0 ? small : large).push_back(k);
+        }
+        while (!small.empty() && !large.empty())
+        {
+            int less = small.back();
+            small.pop_back();
+            int more = large.back();
+            probability[less] = scaled[less];
+            alias[less] = more;
+            scaled[more] -= 1.0 - scaled[less];
+            if (scaled[more] < 1.0)
+            {
+                large.pop_back();
+                small.push_back(more);
+            }
+        }
+        // Остатки равны 1 с точностью до округления
+        for (int k : large)
+        {
+            probability[k] = 1.0;
+            alias[k] = k;
+        }
+        for (int k : small)
+        {
+            probability[k] = 1.0;
+            alias[k] = k;
+        }
+    }
+
+    uint8_t sample(Xoshiro256 &rng) const
+    {
+        uint32_t k = rng.uniformInt(static_cast<uint32_t>(probability.size()));
+        return static_cast<uint8_t>(minDuration + (rng.uniformReal() < probability[k] ? static_cast<int>(k) : alias[k]));
+    }
+
+private:
+    int minDuration;
+    std::vector<double> probability; // Вероятность оставить столбец k
+    std::vector<int> alias;          // Столбец, в который уходит остаток
+};
+
+// Создание распределения по имени из командной строки. Параметр shape зависит от закона,
+// отрицательное значение означает значение по умолчанию:
+//   uniform - равномерное, shape не используется;
+//   zipf    - вес длительности minDuration + k - 1 равен 1 / k^s (короткие работы частые), shape = s, по умолчанию 1;
+//   bimodal - смесь двух дискретных нормальных пиков у 10% и 90% диапазона со стандартным отклонением
+//             в 5% диапазона, shape - доля длинных работ, по умолчанию 0.2;
+//   pareto  - усеченное на maxDuration дискретное распределение Парето с масштабом minDuration:
+//             P(X >= x) = (minDuration / x)^alpha, shape = alpha, по умолчанию 1.5 (тяжелый хвост)
+inline DurationDistribution makeDurationDistribution(const std::string &name, int minDuration, int maxDuration, double shape = -1)
+{
+    if (minDuration < 1 || maxDuration > UINT8_MAX || minDuration > maxDuration)
+    {
+        throw std::invalid_argument("Duration range must satisfy 1 <= min <= max <= 255");
+    }
+    int size = maxDuration - minDuration + 1;
+    std::vector<double> weights(size);
+    if (name == "uniform")
+    {
+        std::fill(weights.begin(), weights.end(), 1.0);
+    }
+    else if (name == "zipf")
+    {
+        double exponent = shape < 0 ? 1.0 : shape;
+        for (int k = 0; k < size; ++k)
+        {
+            weights[k] = std::pow(k + 1.0, -exponent);
+        }
+    }
+    else if (name == "bimodal")
+    {
+        double longShare = shape < 0 ? 0.2 : shape;
+        if (longShare > 1)
+        {
+            throw std::invalid_argument("Bimodal shape is the share of long jobs and must not exceed 1");
+        }
+        double range = std::max(size - 1, 1);
+        double shortPeak = 0.1 * range;
+        double longPeak = 0.9 * range;
+        double deviation = std::max(0.05 * range, 0.5);
+        for (int k = 0; k < size; ++k)
+        {
+            double shortDistance = (k - shortPeak) / deviation;
+            double longDistance = (k - longPeak) / deviation;
+            weights[k] = (1 - longShare) * std::exp(-0.5 * shortDistance * shortDistance) + longShare * std::exp(-0.5 * longDistance * longDistance);
+        }
+    }
+    else if (name == "pareto")
+    {
+        double alpha = shape < 0 ? 1.5 : shape;
+        if (alpha <= 0)
+        {
+            throw std::invalid_argument("Pareto shape (alpha) must be positive");
+        }
+        // Вес x равен P(x <= X < x + 1) непрерывного закона, усечение - нормировкой
+        for (int k = 0; k < size; ++k)
+        {
+            double x = minDuration + k;
+            weights[k] = std::pow(minDuration / x, alpha) - std::pow(minDuration / (x + 1), alpha);
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("Invalid distribution '" + name + "'. Available distributions: uniform, zipf, bimodal, pareto");
+    }
+    return DurationDistribution(minDuration, weights);
+}
+
+// Работы генерируются блоками фиксированного размера: блок b заполняется генератором с зерном
+// deriveSeed(seed, b), поэтому результат зависит только от зерна, а не от числа потоков и порядка блоков
+constexpr size_t jobBlockSize = 1 << 20;
+
+// Блок b: работы [b * jobBlockSize, min(numJobs, (b + 1) * jobBlockSize)) в out.
+// correlation - вероятность повторить длительность предыдущей работы блока: при correlation > 0
+// длительности идут сериями, как у однотипных работ одного пользователя
+inline void generateJobBlock(size_t block, size_t numJobs, const DurationDistribution &distribution, uint64_t seed, double correlation, uint8_t *out)
+{
+    Xoshiro256 rng(deriveSeed(seed, block));
+    size_t count = std::min(numJobs - block * jobBlockSize, jobBlockSize);
+    out[0] = distribution.sample(rng);
+    for (size_t i = 1; i < count; ++i)
+    {
+        out[i] = correlation > 0 && rng.uniformReal() < correlation ? out[i - 1] : distribution.sample(rng);
+    }
+}
+
+// Число потоков генерации: numThreads <= 0 - по числу ядер, но не больше числа блоков
+inline int generatorThreads(int numThreads, size_t numJobs)
+{
+    if (numThreads <= 0)
+    {
+        numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    size_t numBlocks = (numJobs + jobBlockSize - 1) / jobBlockSize;
+    return static_cast<int>(std::min<size_t>(numThreads, std::max<size_t>(numBlocks, 1)));
+}
+
+// Потоковая генерация: блоки идут волнами по блоку на поток, поэтому в памяти не больше numThreads
+// блоков при любом числе работ. Поток t генерирует свой блок и вызывает для него
+// prepare(t, firstJob, durations, count) (например, форматирование текста); затем вызывающий поток
+// передает блоки волны по порядку в consume(t, firstJob, durations, count) (запись в файл).
+// numThreads - результат generatorThreads
+template <typename Prepare, typename Consume>
+void streamJobDurations(size_t numJobs, const DurationDistribution &distribution, uint64_t seed, double correlation, int numThreads,
+                        Prepare prepare, Consume consume)
+{
+    size_t numBlocks = (numJobs + jobBlockSize - 1) / jobBlockSize;
+    std::vector<std::vector<uint8_t>> buffers(numThreads, std::vector<uint8_t>(std::min(numJobs, jobBlockSize)));
+    for (size_t waveBegin = 0; waveBegin < numBlocks; waveBegin += numThreads)
+    {
+        int waveSize = static_cast<int>(std::min<size_t>(numThreads, numBlocks - waveBegin));
+        auto worker = [&](int t)
+        {
+            size_t block = waveBegin + t;
+            size_t firstJob = block * jobBlockSize;
+            generateJobBlock(block, numJobs, distribution, seed, correlation, buffers[t].data());
+            prepare(t, firstJob, buffers[t].data(), std::min(numJobs - firstJob, jobBlockSize));
+        };
+        std::vector<std::thread> workers;
+        for (int t = 1; t < waveSize; ++t)
+        {
+            workers.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto &thread : workers)
+        {
+            thread.join();
+        }
+        for (int t = 0; t < waveSize; ++t)
+        {
+            size_t firstJob = (waveBegin + t) * jobBlockSize;
+            consume(t, firstJob, static_cast<const uint8_t *>(buffers[t].data()), std::min(numJobs - firstJob, jobBlockSize));
+        }
+    }
+}
+
+#endif // JOB_GENERATOR_H
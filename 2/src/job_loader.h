@@ -0,0 +1,442 @@
+#ifndef JOB_LOADER_H
+#define JOB_LOADER_H
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Файл, отображенный в память только для чтения
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string &filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Unable to open file " + filename);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Unable to stat file " + filename);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0)
+        {
+            void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error("Unable to map file " + filename);
+            }
+            bytes = static_cast<const char *>(mapped);
+            madvise(mapped, length, MADV_SEQUENTIAL);
+        }
+        close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (bytes != nullptr)
+        {
+            munmap(const_cast<char *>(bytes), length);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char *bytes = nullptr;
+    size_t length = 0;
+};
+
+// Результат разбора одного куска CSV файла
+struct CsvChunk
+{
+    const char *begin;
+    const char *end;
+    std::vector<uint8_t> durations;
+    size_t lines = 0;       // Количество разобранных строк (для номера строки в ошибке)
+    size_t errorLine = 0;   // Номер строки с ошибкой внутри куска, 0 - ошибок нет
+    std::string errorText;
+};
+
+// Разбор строк "Job ID,Duration" внутри куска. Кусок всегда начинается с начала строки
+inline void parseCsvChunk(CsvChunk &chunk)
+{
+    const char *p = chunk.begin;
+    chunk.durations.reserve((chunk.end - chunk.begin) / 8);
+    while (p < chunk.end)
+    {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', chunk.end - p));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = chunk.end;
+        }
+        chunk.lines++;
+        const char *valueEnd = lineEnd;
+        if (valueEnd > p && valueEnd[-1] == '\r')
+        {
+            valueEnd--;
+        }
+        // Пустые строки (например, перевод строки в конце файла) пропускаем
+        if (valueEnd != p)
+        {
+            const char *comma = static_cast<const char *>(std::memchr(p, ',', valueEnd - p));
+            if (comma == nullptr)
+            {
+                chunk.errorLine = chunk.lines;
+                chunk.errorText = "missing duration column";
+                return;
+            }
+            const char *fieldEnd = static_cast<const char *>(std::memchr(comma + 1, ',', valueEnd - comma - 1));
+            if (fieldEnd == nullptr)
+            {
+                fieldEnd = valueEnd;
+            }
+            // Пробелы вокруг значения допускаются, как в файлах, набранных вручную ("Job_1, 53")
+            const char *valueBegin = comma + 1;
+            while (valueBegin < fieldEnd && (*valueBegin == ' ' || *valueBegin == '\t'))
+            {
+                valueBegin++;
+            }
+            const char *valueLast = fieldEnd;
+            while (valueLast > valueBegin && (valueLast[-1] == ' ' || valueLast[-1] == '\t'))
+            {
+                valueLast--;
+            }
+            unsigned int duration = 0;
+            auto [ptr, ec] = std::from_chars(valueBegin, valueLast, duration);
+            if (ec != std::errc() || ptr != valueLast)
+            {
+                chunk.errorLine = chunk.lines;
+                chunk.errorText = "invalid duration '" + std::string(comma + 1, fieldEnd) + "'";
+                return;
+            }
+            // Длительность хранится в uint8_t, поэтому большие значения - ошибка, а не усечение
+            if (duration > UINT8_MAX)
+            {
+                chunk.errorLine = chunk.lines;
+                chunk.errorText = "duration " + std::to_string(duration) + " does not fit into uint8_t";
+                return;
+            }
+            chunk.durations.push_back(static_cast<uint8_t>(duration));
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// Разбор CSV файла формата "Job ID,Duration", уже отображенного в память.
+// Тело файла делится на куски по границам строк, которые разбираются параллельно
+inline std::vector<uint8_t> parseJobDurationsCSV(const MappedFile &file, const std::string &filename, std::chrono::steady_clock::time_point start)
+{
+    const char *begin = file.data();
+    const char *end = begin + file.size();
+
+    // Пропускаем заголовок
+    const char *header = begin != nullptr ? static_cast<const char *>(std::memchr(begin, '\n', file.size())) : nullptr;
+    const char *body = header != nullptr ? header + 1 : end;
+
+    // Куски не меньше 1 МБ, чтобы маленькие файлы не платили за создание потоков
+    const size_t minChunkSize = 1 << 20;
+    size_t bodySize = end - body;
+    size_t numChunks = std::max<size_t>(1, std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), bodySize / minChunkSize));
+
+    std::vector<CsvChunk> chunks;
+    const char *chunkBegin = body;
+    for (size_t i = 0; i < numChunks && chunkBegin < end; ++i)
+    {
+        const char *chunkEnd = i + 1 == numChunks ? end : body + bodySize * (i + 1) / numChunks;
+        if (chunkEnd < chunkBegin)
+        {
+            chunkEnd = chunkBegin;
+        }
+        // Сдвигаем границу куска до конца строки
+        const char *newline = chunkEnd < end ? static_cast<const char *>(std::memchr(chunkEnd, '\n', end - chunkEnd)) : nullptr;
+        chunkEnd = newline != nullptr ? newline + 1 : end;
+        chunks.push_back({chunkBegin, chunkEnd, {}, 0, 0, {}});
+        chunkBegin = chunkEnd;
+    }
+
+    if (chunks.size() == 1)
+    {
+        parseCsvChunk(chunks[0]);
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        for (auto &chunk : chunks)
+        {
+            workers.emplace_back(parseCsvChunk, std::ref(chunk));
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Склеиваем результаты кусков и сообщаем о первой ошибке с номером строки в файле
+    size_t totalJobs = 0;
+    size_t lineOffset = 1; // Строка заголовка
+    for (const auto &chunk : chunks)
+    {
+        if (chunk.errorLine != 0)
+        {
+            throw std::runtime_error(filename + ":" + std::to_string(lineOffset + chunk.errorLine) + ": " + chunk.errorText);
+        }
+        lineOffset += chunk.lines;
+        totalJobs += chunk.durations.size();
+    }
+    std::vector<uint8_t> jobDurations;
+    jobDurations.reserve(totalJobs);
+    for (const auto &chunk : chunks)
+    {
+        jobDurations.insert(jobDurations.end(), chunk.durations.begin(), chunk.durations.end());
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double megabytes = file.size() / (1024.0 * 1024.0);
+    std::cerr << "Loaded " << jobDurations.size() << " jobs from " << filename << " (" << megabytes << " MB) in "
+              << seconds * 1000 << " ms, " << (seconds > 0 ? megabytes / seconds : 0) << " MB/s" << std::endl;
+    return jobDurations;
+}
+
+// Загрузка длительностей работ из CSV файла формата "Job ID,Duration"
+inline std::vector<uint8_t> loadJobDurationsFromCSV(const std::string &filename)
+{
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(filename);
+    return parseJobDurationsCSV(file, filename, start);
+}
+
+// Заголовок бинарного файла работ. За ним сразу следует массив длительностей
+// jobCount * durationWidth байт без разделителей
+struct JobFileHeader
+{
+    char magic[8];          // "JOBSBIN1"
+    uint32_t version;       // Версия формата
+    uint32_t durationWidth; // Размер длительности в байтах
+    uint64_t jobCount;      // Количество работ
+    uint64_t checksum;      // Контрольная сумма массива длительностей (jobFileChecksum)
+};
+
+static_assert(sizeof(JobFileHeader) == 32, "JobFileHeader must be packed into 32 bytes");
+
+constexpr char jobFileMagic[8] = {'J', 'O', 'B', 'S', 'B', 'I', 'N', '1'};
+constexpr uint32_t jobFileVersion = 1;
+
+// FNV-1a по 64-битным словам; хвост короче слова дополняется нулями.
+// Обработка словами, а не байтами, держит проверку на уровне миллисекунд для 10M работ.
+// hash - сумма предыдущих частей массива: сумма продолжается по частям, размеры которых, кроме последней, кратны 8
+constexpr uint64_t jobFileChecksumBasis = 0xCBF29CE484222325ULL;
+
+inline uint64_t jobFileChecksum(const uint8_t *data, size_t size, uint64_t hash = jobFileChecksumBasis)
+{
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 0x100000001B3ULL;
+    }
+    if (i < size)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, size - i);
+        hash = (hash ^ word) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+inline bool isBinaryJobFile(const MappedFile &file)
+{
+    return file.size() >= sizeof(jobFileMagic) && std::memcmp(file.data(), jobFileMagic, sizeof(jobFileMagic)) == 0;
+}
+
+// Разбор бинарного файла работ, уже отображенного в память, с проверкой заголовка и контрольной суммы
+inline std::vector<uint8_t> parseJobDurationsBinary(const MappedFile &file, const std::string &filename, std::chrono::steady_clock::time_point start)
+{
+    if (file.size() < sizeof(JobFileHeader) || !isBinaryJobFile(file))
+    {
+        throw std::runtime_error(filename + ": not a binary job file");
+    }
+    JobFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.version != jobFileVersion)
+    {
+        throw std::runtime_error(filename + ": unsupported job file version " + std::to_string(header.version));
+    }
+    if (header.durationWidth != sizeof(uint8_t))
+    {
+        throw std::runtime_error(filename + ": unsupported duration width " + std::to_string(header.durationWidth));
+    }
+    if (file.size() - sizeof(header) != header.jobCount * header.durationWidth)
+    {
+        throw std::runtime_error(filename + ": file size does not match job count " + std::to_string(header.jobCount));
+    }
+
+    const uint8_t *durations = reinterpret_cast<const uint8_t *>(file.data() + sizeof(header));
+    if (jobFileChecksum(durations, header.jobCount) != header.checksum)
+    {
+        throw std::runtime_error(filename + ": checksum mismatch");
+    }
+    std::vector<uint8_t> jobDurations(durations, durations + header.jobCount);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Loaded " << jobDurations.size() << " jobs from " << filename << " in " << seconds * 1000 << " ms" << std::endl;
+    return jobDurations;
+}
+
+// Загрузка длительностей из бинарного файла работ
+inline std::vector<uint8_t> loadJobDurationsFromBinary(const std::string &filename)
+{
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(filename);
+    return parseJobDurationsBinary(file, filename, start);
+}
+
+// Потоковая запись бинарного файла работ: длительности дописываются частями по мере получения,
+// а заголовок с количеством работ и контрольной суммой переписывается в finish()
+class JobFileWriter
+{
+public:
+    explicit JobFileWriter(const std::string &filename)
+        : filename(filename), file(filename, std::ios::binary | std::ios::trunc)
+    {
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Unable to open file " + filename);
+        }
+        JobFileHeader header{};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+
+    // Размеры всех частей, кроме последней, должны быть кратны 8 (см. jobFileChecksum)
+    void write(const uint8_t *durations, size_t count)
+    {
+        if (jobCount % 8 != 0)
+        {
+            throw std::logic_error("JobFileWriter: only the last part may have a size not divisible by 8");
+        }
+        checksum = jobFileChecksum(durations, count, checksum);
+        jobCount += count;
+        file.write(reinterpret_cast<const char *>(durations), count);
+    }
+
+    void finish()
+    {
+        JobFileHeader header{};
+        std::memcpy(header.magic, jobFileMagic, sizeof(jobFileMagic));
+        header.version = jobFileVersion;
+        header.durationWidth = sizeof(uint8_t);
+        header.jobCount = jobCount;
+        header.checksum = checksum;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.flush();
+        if (!file)
+        {
+            throw std::runtime_error("Unable to write file " + filename);
+        }
+    }
+
+private:
+    std::string filename;
+    std::ofstream file;
+    uint64_t jobCount = 0;
+    uint64_t checksum = jobFileChecksumBasis;
+};
+
+// Запись длительностей в бинарный файл работ
+inline void saveJobDurationsToBinary(const std::string &filename, const std::vector<uint8_t> &jobDurations)
+{
+    JobFileWriter writer(filename);
+    writer.write(jobDurations.data(), jobDurations.size());
+    writer.finish();
+}
+
+// Запись строк "Job_i,duration" для count работ, начиная с работы firstJob, в буфер;
+// durations - их длительности, номера работ начинаются с 1, как в gen_tasks.py
+inline void formatCsvRows(const uint8_t *durations, size_t firstJob, size_t count, std::string &text)
+{
+    text.resize(count * 26); // "Job_" + 20 цифр + "," + 3 цифры + "\n"
+    char *p = text.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::memcpy(p, "Job_", 4);
+        p = std::to_chars(p + 4, text.data() + text.size(), firstJob + i + 1).ptr;
+        *p++ = ',';
+        p = std::to_chars(p, text.data() + text.size(), static_cast<unsigned int>(durations[i])).ptr;
+        *p++ = '\n';
+    }
+    text.resize(p - text.data());
+}
+
+// Запись длительностей в CSV файл формата "Job ID,Duration".
+// Строки форматируются параллельно волнами по куску на поток и пишутся по порядку,
+// поэтому памяти нужно не больше одной волны текста независимо от числа работ
+inline void saveJobDurationsToCSV(const std::string &filename, const std::vector<uint8_t> &jobDurations, int numThreads = 0)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to open file " + filename);
+    }
+    file << "Job ID,Duration\n";
+
+    const size_t chunkSize = 1 << 20;
+    if (numThreads <= 0)
+    {
+        numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    std::vector<std::string> texts(numThreads);
+    for (size_t waveBegin = 0; waveBegin < jobDurations.size(); waveBegin += chunkSize * numThreads)
+    {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < numThreads; ++t)
+        {
+            size_t begin = std::min(jobDurations.size(), waveBegin + chunkSize * t);
+            size_t end = std::min(jobDurations.size(), begin + chunkSize);
+            workers.emplace_back(formatCsvRows, jobDurations.data() + begin, begin, end - begin, std::ref(texts[t]));
+        }
+        for (int t = 0; t < numThreads; ++t)
+        {
+            workers[t].join();
+            file.write(texts[t].data(), texts[t].size());
+        }
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Unable to write file " + filename);
+    }
+}
+
+// Загрузка длительностей работ из файла любого поддерживаемого формата.
+// Бинарный формат определяется по сигнатуре, иначе файл разбирается как CSV
+inline std::vector<uint8_t> loadJobDurations(const std::string &filename)
+{
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(filename);
+    return isBinaryJobFile(file) ? parseJobDurationsBinary(file, filename, start) : parseJobDurationsCSV(file, filename, start);
+}
+
+#endif // JOB_LOADER_H
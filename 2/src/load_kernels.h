@@ -0,0 +1,375 @@
+#ifndef LOAD_KERNELS_H
+#define LOAD_KERNELS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LOAD_KERNELS_X86 1
+#endif
+
+// Ядра полного пересчета нагрузок: гистограмма нагрузок по назначению работ, поиск процессоров
+// с минимальной и максимальной нагрузкой и оценка пакета ходов.
+// Ядра есть в скалярном варианте и в вариантах AVX2 и AVX-512, собранных атрибутом target, поэтому
+// программа собирается без -mavx2 и работает на любом x86-64. Вариант выбирается один раз при первом
+// обращении по возможностям процессора (__builtin_cpu_supports).
+// Все варианты дают одинаковый результат, включая выбор первого индекса при равенстве.
+// Гистограмма AVX-512 копит суммы в отдельном наборе на каждую полосу (gather / scatter без конфликтов
+// адресов); в AVX2 нет scatter, поэтому уровень AVX2 использует скалярную гистограмму
+
+enum class SimdLevel
+{
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+inline const char *simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Scalar:
+        return "scalar";
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Avx512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+inline SimdLevel detectSimdLevel()
+{
+#ifdef LOAD_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::Avx2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+// Номера процессоров с минимальной и максимальной нагрузкой (первые при равенстве)
+struct LoadRange
+{
+    int minIndex;
+    int maxIndex;
+};
+
+namespace load_kernels
+{
+    // Гистограмма: loads[assignment[i]] += durations[i]. Четыре независимых набора сумм разрывают
+    // зависимость по памяти, когда подряд идущие работы стоят на одном процессоре (LPT, малое P)
+    inline void accumulateLoadsScalar(const int *assignment, const uint8_t *durations, size_t numJobs, int numProcessors, long long *loads)
+    {
+        std::vector<long long> banks(4 * static_cast<size_t>(numProcessors), 0);
+        long long *bank0 = banks.data();
+        long long *bank1 = bank0 + numProcessors;
+        long long *bank2 = bank1 + numProcessors;
+        long long *bank3 = bank2 + numProcessors;
+        size_t i = 0;
+        for (; i + 4 <= numJobs; i += 4)
+        {
+            bank0[assignment[i]] += durations[i];
+            bank1[assignment[i + 1]] += durations[i + 1];
+            bank2[assignment[i + 2]] += durations[i + 2];
+            bank3[assignment[i + 3]] += durations[i + 3];
+        }
+        for (; i < numJobs; ++i)
+        {
+            bank0[assignment[i]] += durations[i];
+        }
+        for (int p = 0; p < numProcessors; ++p)
+        {
+            loads[p] += bank0[p] + bank1[p] + bank2[p] + bank3[p];
+        }
+    }
+
+    inline LoadRange loadRangeScalar(const long long *loads, int count)
+    {
+        LoadRange range{0, 0};
+        for (int i = 1; i < count; ++i)
+        {
+            range.minIndex = loads[i] < loads[range.minIndex] ? i : range.minIndex;
+            range.maxIndex = loads[i] > loads[range.maxIndex] ? i : range.maxIndex;
+        }
+        return range;
+    }
+
+    // Номер кандидата с наименьшим max(first[k], second[k]) (первый при равенстве)
+    inline int argMinOfMaxScalar(const long long *first, const long long *second, int count)
+    {
+        int best = 0;
+        long long bestValue = std::max(first[0], second[0]);
+        for (int k = 1; k < count; ++k)
+        {
+            long long value = std::max(first[k], second[k]);
+            if (value < bestValue)
+            {
+                best = k;
+                bestValue = value;
+            }
+        }
+        return best;
+    }
+
+#ifdef LOAD_KERNELS_X86
+    // Сведение векторов (значение, номер) к одному: меньшее значение, при равенстве - меньший номер
+    inline LoadRange finishRange(const long long *minValues, const long long *minIndices, const long long *maxValues, const long long *maxIndices, int lanes)
+    {
+        LoadRange range{static_cast<int>(minIndices[0]), static_cast<int>(maxIndices[0])};
+        long long minValue = minValues[0];
+        long long maxValue = maxValues[0];
+        for (int l = 1; l < lanes; ++l)
+        {
+            if (minValues[l] < minValue || (minValues[l] == minValue && minIndices[l] < range.minIndex))
+            {
+                minValue = minValues[l];
+                range.minIndex = static_cast<int>(minIndices[l]);
+            }
+            if (maxValues[l] > maxValue || (maxValues[l] == maxValue && maxIndices[l] < range.maxIndex))
+            {
+                maxValue = maxValues[l];
+                range.maxIndex = static_cast<int>(maxIndices[l]);
+            }
+        }
+        return range;
+    }
+
+    // Сведение векторов (значение, номер) кандидатов: наименьшее значение, при равенстве - меньший номер
+    inline int finishArgMin(const long long *values, const long long *indices, int lanes)
+    {
+        int best = static_cast<int>(indices[0]);
+        long long bestValue = values[0];
+        for (int l = 1; l < lanes; ++l)
+        {
+            if (values[l] < bestValue || (values[l] == bestValue && indices[l] < best))
+            {
+                best = static_cast<int>(indices[l]);
+                bestValue = values[l];
+            }
+        }
+        return best;
+    }
+
+    // Сравнение и смешивание 64-битных целых: в AVX2 нет vpminsq/vpmaxsq
+    __attribute__((target("avx2"))) inline LoadRange loadRangeAvx2(const long long *loads, int count)
+    {
+        if (count < 8)
+        {
+            return loadRangeScalar(loads, count);
+        }
+        __m256i index = _mm256_setr_epi64x(0, 1, 2, 3);
+        const __m256i step = _mm256_set1_epi64x(4);
+        __m256i minValues = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(loads));
+        __m256i maxValues = minValues;
+        __m256i minIndices = index;
+        __m256i maxIndices = index;
+        int i = 4;
+        for (; i + 4 <= count; i += 4)
+        {
+            index = _mm256_add_epi64(index, step);
+            __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(loads + i));
+            // Строгие сравнения оставляют в полосе первый экстремум
+            __m256i less = _mm256_cmpgt_epi64(minValues, values);
+            __m256i greater = _mm256_cmpgt_epi64(values, maxValues);
+            minValues = _mm256_blendv_epi8(minValues, values, less);
+            minIndices = _mm256_blendv_epi8(minIndices, index, less);
+            maxValues = _mm256_blendv_epi8(maxValues, values, greater);
+            maxIndices = _mm256_blendv_epi8(maxIndices, index, greater);
+        }
+        alignas(32) long long lanes[4][4];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes[0]), minValues);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes[1]), minIndices);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes[2]), maxValues);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes[3]), maxIndices);
+        LoadRange range = finishRange(lanes[0], lanes[1], lanes[2], lanes[3], 4);
+        for (; i < count; ++i)
+        {
+            range.minIndex = loads[i] < loads[range.minIndex] ? i : range.minIndex;
+            range.maxIndex = loads[i] > loads[range.maxIndex] ? i : range.maxIndex;
+        }
+        return range;
+    }
+
+    // max(first[i..i+3], second[i..i+3])
+    __attribute__((target("avx2"))) inline __m256i peakAvx2(const long long *first, const long long *second, int i)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(second + i));
+        return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+    }
+
+    __attribute__((target("avx2"))) inline int argMinOfMaxAvx2(const long long *first, const long long *second, int count)
+    {
+        if (count < 8)
+        {
+            return argMinOfMaxScalar(first, second, count);
+        }
+        __m256i index = _mm256_setr_epi64x(0, 1, 2, 3);
+        const __m256i step = _mm256_set1_epi64x(4);
+        __m256i bestValues = peakAvx2(first, second, 0);
+        __m256i bestIndices = index;
+        int i = 4;
+        for (; i + 4 <= count; i += 4)
+        {
+            index = _mm256_add_epi64(index, step);
+            __m256i values = peakAvx2(first, second, i);
+            __m256i less = _mm256_cmpgt_epi64(bestValues, values);
+            bestValues = _mm256_blendv_epi8(bestValues, values, less);
+            bestIndices = _mm256_blendv_epi8(bestIndices, index, less);
+        }
+        alignas(32) long long values[4];
+        alignas(32) long long indices[4];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(values), bestValues);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(indices), bestIndices);
+        int best = finishArgMin(values, indices, 4);
+        long long bestValue = std::max(first[best], second[best]);
+        for (; i < count; ++i)
+        {
+            long long value = std::max(first[i], second[i]);
+            if (value < bestValue)
+            {
+                best = i;
+                bestValue = value;
+            }
+        }
+        return best;
+    }
+
+    __attribute__((target("avx512f"))) inline LoadRange loadRangeAvx512(const long long *loads, int count)
+    {
+        if (count < 16)
+        {
+            return loadRangeScalar(loads, count);
+        }
+        __m512i index = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m512i step = _mm512_set1_epi64(8);
+        __m512i minValues = _mm512_loadu_si512(loads);
+        __m512i maxValues = minValues;
+        __m512i minIndices = index;
+        __m512i maxIndices = index;
+        int i = 8;
+        for (; i + 8 <= count; i += 8)
+        {
+            index = _mm512_add_epi64(index, step);
+            __m512i values = _mm512_loadu_si512(loads + i);
+            __mmask8 less = _mm512_cmplt_epi64_mask(values, minValues);
+            __mmask8 greater = _mm512_cmpgt_epi64_mask(values, maxValues);
+            minValues = _mm512_mask_mov_epi64(minValues, less, values);
+            minIndices = _mm512_mask_mov_epi64(minIndices, less, index);
+            maxValues = _mm512_mask_mov_epi64(maxValues, greater, values);
+            maxIndices = _mm512_mask_mov_epi64(maxIndices, greater, index);
+        }
+        alignas(64) long long lanes[4][8];
+        _mm512_store_si512(lanes[0], minValues);
+        _mm512_store_si512(lanes[1], minIndices);
+        _mm512_store_si512(lanes[2], maxValues);
+        _mm512_store_si512(lanes[3], maxIndices);
+        LoadRange range = finishRange(lanes[0], lanes[1], lanes[2], lanes[3], 8);
+        for (; i < count; ++i)
+        {
+            range.minIndex = loads[i] < loads[range.minIndex] ? i : range.minIndex;
+            range.maxIndex = loads[i] > loads[range.maxIndex] ? i : range.maxIndex;
+        }
+        return range;
+    }
+
+    // Сумма полосы l процессора p лежит в banks[8 * p + l]: адреса одного scatter всегда различны.
+    // Маскированные варианты gather и преобразования не читают неопределенный исходный вектор
+    __attribute__((target("avx512f"))) inline void accumulateLoadsAvx512(const int *assignment, const uint8_t *durations, size_t numJobs, int numProcessors, long long *loads)
+    {
+        std::vector<long long> banks(8 * static_cast<size_t>(numProcessors), 0);
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m512i zero = _mm512_setzero_si512();
+        size_t i = 0;
+        for (; i + 8 <= numJobs; i += 8)
+        {
+            __m256i processors = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(assignment + i));
+            __m256i slots = _mm256_add_epi32(_mm256_slli_epi32(processors, 3), lanes);
+            __m512i values = _mm512_maskz_cvtepu8_epi64(0xFF, _mm_loadl_epi64(reinterpret_cast<const __m128i *>(durations + i)));
+            __m512i sums = _mm512_mask_i32gather_epi64(zero, 0xFF, slots, banks.data(), 8);
+            _mm512_i32scatter_epi64(banks.data(), slots, _mm512_add_epi64(sums, values), 8);
+        }
+        for (; i < numJobs; ++i)
+        {
+            banks[8 * static_cast<size_t>(assignment[i])] += durations[i];
+        }
+        for (int p = 0; p < numProcessors; ++p)
+        {
+            const long long *bank = &banks[8 * static_cast<size_t>(p)];
+            loads[p] += bank[0] + bank[1] + bank[2] + bank[3] + bank[4] + bank[5] + bank[6] + bank[7];
+        }
+    }
+
+    // Пакет из 8 кандидатов - один вектор; хвост обрабатывается маской
+    __attribute__((target("avx512f"))) inline int argMinOfMaxAvx512(const long long *first, const long long *second, int count)
+    {
+        __m512i bestValues = _mm512_set1_epi64(INT64_MAX);
+        __m512i bestIndices = _mm512_setzero_si512();
+        __m512i index = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m512i step = _mm512_set1_epi64(8);
+        for (int i = 0; i < count; i += 8)
+        {
+            __mmask8 active = static_cast<__mmask8>(count - i >= 8 ? 0xFF : (1u << (count - i)) - 1);
+            __m512i a = _mm512_maskz_loadu_epi64(active, first + i);
+            __m512i b = _mm512_maskz_loadu_epi64(active, second + i);
+            __m512i values = _mm512_mask_mov_epi64(a, _mm512_cmpgt_epi64_mask(b, a), b);
+            __mmask8 less = _mm512_mask_cmplt_epi64_mask(active, values, bestValues);
+            bestValues = _mm512_mask_mov_epi64(bestValues, less, values);
+            bestIndices = _mm512_mask_mov_epi64(bestIndices, less, index);
+            index = _mm512_add_epi64(index, step);
+        }
+        alignas(64) long long values[8];
+        alignas(64) long long indices[8];
+        _mm512_store_si512(values, bestValues);
+        _mm512_store_si512(indices, bestIndices);
+        return finishArgMin(values, indices, 8);
+    }
+#endif
+}
+
+// Таблица вариантов ядер одного уровня
+struct LoadKernels
+{
+    SimdLevel level;
+    // Гистограмма: loads[assignment[i]] += durations[i] для numJobs работ, номера процессоров < numProcessors
+    void (*accumulateLoads)(const int *assignment, const uint8_t *durations, size_t numJobs, int numProcessors, long long *loads);
+    // Экстремумы count > 0 нагрузок
+    LoadRange (*loadRange)(const long long *loads, int count);
+    // Лучший из count > 0 кандидатов по наибольшей из двух нагрузок
+    int (*argMinOfMax)(const long long *first, const long long *second, int count);
+};
+
+// Ядра заданного уровня; уровень выше поддерживаемого процессором использовать нельзя
+inline LoadKernels makeLoadKernels(SimdLevel level)
+{
+#ifdef LOAD_KERNELS_X86
+    if (level == SimdLevel::Avx512)
+    {
+        return {level, load_kernels::accumulateLoadsAvx512, load_kernels::loadRangeAvx512, load_kernels::argMinOfMaxAvx512};
+    }
+    if (level == SimdLevel::Avx2)
+    {
+        return {level, load_kernels::accumulateLoadsScalar, load_kernels::loadRangeAvx2, load_kernels::argMinOfMaxAvx2};
+    }
+#endif
+    return {SimdLevel::Scalar, load_kernels::accumulateLoadsScalar, load_kernels::loadRangeScalar, load_kernels::argMinOfMaxScalar};
+}
+
+// Ядра лучшего уровня, доступного процессору
+inline const LoadKernels &loadKernels()
+{
+    static const LoadKernels kernels = makeLoadKernels(detectSimdLevel());
+    return kernels;
+}
+
+#endif // LOAD_KERNELS_H
@@ -0,0 +1,73 @@
+#ifndef LOAD_TREE_H
+#define LOAD_TREE_H
+
+#include <vector>
+
+// Дерево отрезков над нагрузками процессоров.
+// Хранит в каждом узле номер процессора с максимальной и минимальной нагрузкой в поддереве,
+// поэтому максимум и минимум доступны за O(1), а изменение одной нагрузки стоит O(log P).
+// Нагрузки 64-битные: с коэффициентами скорости процессоров (processor_model.h) они измеряются
+// в долях единицы времени и для десятков миллионов работ не помещаются в int
+class LoadExtremesTree
+{
+public:
+    LoadExtremesTree() = default;
+
+    explicit LoadExtremesTree(const std::vector<long long> &initialLoads)
+    {
+        build(initialLoads);
+    }
+
+    // Полное построение дерева по вектору нагрузок за O(P)
+    void build(const std::vector<long long> &initialLoads)
+    {
+        size = static_cast<int>(initialLoads.size());
+        loads = initialLoads;
+        maxNode.assign(2 * size, 0);
+        minNode.assign(2 * size, 0);
+        // Листья лежат в узлах [size, 2 * size)
+        for (int p = 0; p < size; ++p)
+        {
+            maxNode[size + p] = p;
+            minNode[size + p] = p;
+        }
+        // Корень - узел 1 (при одном процессоре это сам лист)
+        for (int i = size - 1; i >= 1; --i)
+        {
+            pull(i);
+        }
+    }
+
+    // Изменение нагрузки процессора на delta с обновлением пути до корня
+    void add(int processor, long long delta)
+    {
+        loads[processor] += delta;
+        for (int i = (size + processor) / 2; i >= 1; i /= 2)
+        {
+            pull(i);
+        }
+    }
+
+    long long operator[](int processor) const { return loads[processor]; }
+    int maxProcessor() const { return maxNode[1]; }
+    int minProcessor() const { return minNode[1]; }
+    long long maxLoad() const { return loads[maxProcessor()]; }
+    long long minLoad() const { return loads[minProcessor()]; }
+    const std::vector<long long> &values() const { return loads; }
+
+private:
+    void pull(int i)
+    {
+        int left = 2 * i;
+        int right = 2 * i + 1;
+        maxNode[i] = loads[maxNode[left]] >= loads[maxNode[right]] ? maxNode[left] : maxNode[right];
+        minNode[i] = loads[minNode[left]] <= loads[minNode[right]] ? minNode[left] : minNode[right];
+    }
+
+    int size = 0;
+    std::vector<long long> loads; // Нагрузки процессоров
+    std::vector<int> maxNode;     // Номер процессора с максимальной нагрузкой в поддереве
+    std::vector<int> minNode;     // Номер процессора с минимальной нагрузкой в поддереве
+};
+
+#endif // LOAD_TREE_H
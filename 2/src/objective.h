@@ -0,0 +1,182 @@
+#ifndef OBJECTIVE_H
+#define OBJECTIVE_H
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "load_tree.h"
+
+// Критерии качества расписания
+enum class ObjectiveKind
+{
+    Imbalance, // K1: Tmax - Tmin
+    Makespan,  // Tmax
+    Variance,  // Дисперсия нагрузок процессоров
+    Count
+};
+
+inline const char *objectiveKindName(ObjectiveKind kind)
+{
+    static const char *names[] = {"imbalance", "makespan", "variance"};
+    return names[static_cast<int>(kind)];
+}
+
+// Сумма квадратов нагрузок, поддерживаемая при каждом перемещении работы за O(1).
+// Вместе с неизменной суммой нагрузок дает дисперсию без прохода по процессорам.
+// Хранится в 128-битном целом: для 100M работ квадрат нагрузки не помещается в 64 бита,
+// а целочисленное состояние после отката совпадает с исходным побитово
+class LoadMoments
+{
+public:
+    void build(const std::vector<long long> &loads)
+    {
+        numProcessors = static_cast<int>(loads.size());
+        totalLoad = 0;
+        sumSquares = 0;
+        for (long long load : loads)
+        {
+            totalLoad += load;
+            sumSquares += static_cast<__int128>(load) * load;
+        }
+    }
+
+    // Перенос работы длительности duration между одинаковыми процессорами (нагрузки до переноса):
+    // (f - d)^2 + (t + d)^2 - f^2 - t^2 = 2d (t - f + d), сумма нагрузок не меняется
+    void move(long long fromLoad, long long toLoad, int duration)
+    {
+        sumSquares += 2 * static_cast<__int128>(duration) * (toLoad - fromLoad + duration);
+    }
+
+    // Перенос работы с процессора нагрузки fromLoad, где она занимала fromTime, на процессор нагрузки
+    // toLoad, где она займет toTime (нагрузки до переноса): (f - a)^2 + (t + b)^2 - f^2 - t^2 = a (a - 2f) + b (b + 2t)
+    void move(long long fromLoad, long long fromTime, long long toLoad, long long toTime)
+    {
+        sumSquares += static_cast<__int128>(fromTime) * (fromTime - 2 * fromLoad) + static_cast<__int128>(toTime) * (toTime + 2 * toLoad);
+        totalLoad += toTime - fromTime;
+    }
+
+    // Дисперсия нагрузок: (P * sum L^2 - (sum L)^2) / P^2, в квадратах единиц нагрузки
+    double variance() const
+    {
+        if (numProcessors == 0)
+        {
+            return 0.0;
+        }
+        __int128 numerator = sumSquares * numProcessors - static_cast<__int128>(totalLoad) * totalLoad;
+        return static_cast<double>(numerator) / (static_cast<double>(numProcessors) * numProcessors);
+    }
+
+private:
+    int numProcessors = 0;
+    long long totalLoad = 0;
+    __int128 sumSquares = 0;
+};
+
+// Целевая функция - взвешенная сумма критериев; отдельный критерий - сумма с одним весом 1.
+// Состояние критериев поддерживается решением инкрементально (экстремумы - LoadExtremesTree,
+// дисперсия - LoadMoments), поэтому любая комбинация вычисляется за O(1)
+class SchedulingObjective
+{
+public:
+    // По умолчанию - исходный критерий K1
+    SchedulingObjective()
+    {
+        weights[static_cast<int>(ObjectiveKind::Imbalance)] = 1.0;
+    }
+
+    double weight(ObjectiveKind kind) const { return weights[static_cast<int>(kind)]; }
+    void setWeight(ObjectiveKind kind, double value) { weights[static_cast<int>(kind)] = value; }
+
+    // timeScale - число единиц нагрузки в единице времени (см. ProcessorModel), 1 для одинаковых процессоров
+    double evaluate(const LoadExtremesTree &loads, const LoadMoments &moments, double timeScale = 1.0) const
+    {
+        long long Tmax = loads.maxLoad();
+        long long Tmin = loads.minLoad();
+        double cost = (weight(ObjectiveKind::Imbalance) * (Tmax - Tmin) + weight(ObjectiveKind::Makespan) * Tmax) / timeScale;
+        if (weight(ObjectiveKind::Variance) != 0.0)
+        {
+            cost += weight(ObjectiveKind::Variance) * moments.variance() / (timeScale * timeScale);
+        }
+        return cost;
+    }
+
+    // Запись в формате parseObjective, например "imbalance" или "imbalance+0.5*makespan"
+    std::string describe() const
+    {
+        std::string text;
+        for (int k = 0; k < static_cast<int>(ObjectiveKind::Count); ++k)
+        {
+            if (weights[k] == 0.0)
+            {
+                continue;
+            }
+            if (!text.empty())
+            {
+                text += "+";
+            }
+            if (weights[k] != 1.0)
+            {
+                // Кратчайшая запись, из которой вес восстанавливается точно; без экспоненты,
+                // чтобы '+' в "1e+07" не разделял критерии при обратном разборе parseObjective
+                char number[512];
+                char *numberEnd = std::to_chars(number, number + sizeof(number), weights[k], std::chars_format::fixed).ptr;
+                text += std::string(number, numberEnd) + "*";
+            }
+            text += objectiveKindName(static_cast<ObjectiveKind>(k));
+        }
+        return text;
+    }
+
+private:
+    double weights[static_cast<int>(ObjectiveKind::Count)] = {};
+};
+
+// Разбор целевой функции из командной строки: критерии imbalance, makespan, variance,
+// соединенные '+', с необязательным весом перед '*': "makespan", "imbalance+0.01*variance"
+inline SchedulingObjective parseObjective(const std::string &spec)
+{
+    SchedulingObjective objective;
+    objective.setWeight(ObjectiveKind::Imbalance, 0.0);
+    size_t begin = 0;
+    while (begin <= spec.size())
+    {
+        size_t end = std::min(spec.find('+', begin), spec.size());
+        std::string term = spec.substr(begin, end - begin);
+        double weight = 1.0;
+        size_t star = term.find('*');
+        if (star != std::string::npos)
+        {
+            size_t parsed = 0;
+            try
+            {
+                weight = std::stod(term.substr(0, star), &parsed);
+            }
+            catch (const std::exception &)
+            {
+                parsed = std::string::npos;
+            }
+            if (parsed != star || weight < 0)
+            {
+                throw std::invalid_argument("Invalid objective weight '" + term.substr(0, star) + "'");
+            }
+            term = term.substr(star + 1);
+        }
+        int kind = 0;
+        while (kind < static_cast<int>(ObjectiveKind::Count) && term != objectiveKindName(static_cast<ObjectiveKind>(kind)))
+        {
+            kind++;
+        }
+        if (kind == static_cast<int>(ObjectiveKind::Count))
+        {
+            throw std::invalid_argument("Invalid objective '" + term + "'. Available objectives: imbalance, makespan, variance, or a weighted sum like imbalance+0.5*makespan");
+        }
+        objective.setWeight(static_cast<ObjectiveKind>(kind), objective.weight(static_cast<ObjectiveKind>(kind)) + weight);
+        begin = end + 1;
+    }
+    return objective;
+}
+
+#endif // OBJECTIVE_H
@@ -0,0 +1,67 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Разбор командной строки: позиционные аргументы и необязательные ключи вида --name value или --name=value.
+// Ключи могут стоять в любом месте, поэтому прежний позиционный интерфейс программ сохраняется
+class CommandLine
+{
+public:
+    CommandLine() = default;
+
+    // knownOptions - допустимые имена ключей без "--"; неизвестный ключ считается ошибкой
+    CommandLine(int argc, char *argv[], const std::set<std::string> &knownOptions)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument = argv[i];
+            if (argument.rfind("--", 0) != 0)
+            {
+                positionalArguments.push_back(argument);
+                continue;
+            }
+            std::string name = argument.substr(2);
+            std::string value;
+            size_t equals = name.find('=');
+            if (equals != std::string::npos)
+            {
+                value = name.substr(equals + 1);
+                name.resize(equals);
+            }
+            else if (i + 1 < argc)
+            {
+                value = argv[++i];
+            }
+            else
+            {
+                throw std::invalid_argument("Option --" + name + " requires a value");
+            }
+            if (knownOptions.count(name) == 0)
+            {
+                throw std::invalid_argument("Unknown option --" + name);
+            }
+            options[name] = value;
+        }
+    }
+
+    const std::vector<std::string> &positional() const { return positionalArguments; }
+
+    bool has(const std::string &name) const { return options.count(name) != 0; }
+
+    std::string get(const std::string &name, const std::string &defaultValue) const
+    {
+        auto it = options.find(name);
+        return it == options.end() ? defaultValue : it->second;
+    }
+
+private:
+    std::vector<std::string> positionalArguments;
+    std::map<std::string, std::string> options;
+};
+
+#endif // OPTIONS_H
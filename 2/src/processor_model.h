@@ -0,0 +1,268 @@
+#ifndef PROCESSOR_MODEL_H
+#define PROCESSOR_MODEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "load_kernels.h"
+#include "random.h"
+
+// Неоднородные процессоры и ограничения на размещение работ.
+//
+// Скорость: работа длительности d выполняется на процессоре p за d * timeFactor(p) тактов, где
+// timeFactor(p) = round(timeScale / speed(p)). Нагрузки остаются целыми, поэтому откат хода
+// возвращает их побитово, а стоимость делится на timeScale только при вычислении.
+//
+// Допустимые процессоры: для работ с ограничением хранится отсортированный список процессоров
+// в формате CSR (offsets + processors); работа без списка может выполняться где угодно.
+// Случайный допустимый процессор выбирается за O(1), проверка допустимости - бинарным поиском
+// по списку работы. Модель неизменяема после построения и разделяется всеми копиями решения;
+// решение без модели (nullptr) работает по прежнему быстрому пути для одинаковых процессоров
+class ProcessorModel
+{
+public:
+    // Тактов на единицу длительности у процессора скорости 1
+    static constexpr int speedTimeScale = 1000;
+
+    ProcessorModel(int numJobs, int numProcessors)
+        : numJobs(numJobs), numProcessors(numProcessors), timeFactors(numProcessors, 1)
+    {
+    }
+
+    // Скорости процессоров (1 - обычная, 2 - вдвое быстрее)
+    void setSpeeds(const std::vector<double> &speeds)
+    {
+        if (static_cast<int>(speeds.size()) != numProcessors)
+        {
+            throw std::invalid_argument("Expected " + std::to_string(numProcessors) + " processor speeds, got " + std::to_string(speeds.size()));
+        }
+        timeScale = speedTimeScale;
+        for (int p = 0; p < numProcessors; ++p)
+        {
+            if (!(speeds[p] > 0) || !std::isfinite(speeds[p]))
+            {
+                throw std::invalid_argument("Processor speed must be positive, got " + std::to_string(speeds[p]) + " for processor " + std::to_string(p));
+            }
+            timeFactors[p] = static_cast<int>(std::clamp<double>(std::llround(speedTimeScale / speeds[p]), 1, std::numeric_limits<int>::max() / 256));
+        }
+    }
+
+    // Допустимые процессоры работ: пары (работа, список процессоров). Работы без пары не ограничены
+    void setAffinity(std::vector<std::pair<int, std::vector<int>>> allowed)
+    {
+        std::sort(allowed.begin(), allowed.end(), [](const auto &a, const auto &b)
+                  { return a.first < b.first; });
+        affinityOffsets.assign(static_cast<size_t>(numJobs) + 1, 0);
+        affinityProcessors.clear();
+        size_t k = 0;
+        for (int job = 0; job < numJobs; ++job)
+        {
+            affinityOffsets[job] = static_cast<uint32_t>(affinityProcessors.size());
+            if (k < allowed.size() && allowed[k].first == job)
+            {
+                std::vector<int> &processors = allowed[k].second;
+                std::sort(processors.begin(), processors.end());
+                processors.erase(std::unique(processors.begin(), processors.end()), processors.end());
+                if (processors.empty() || processors.front() < 0 || processors.back() >= numProcessors)
+                {
+                    throw std::invalid_argument("Allowed processors of job " + std::to_string(job + 1) + " must be a non-empty subset of 0.." + std::to_string(numProcessors - 1));
+                }
+                affinityProcessors.insert(affinityProcessors.end(), processors.begin(), processors.end());
+                if (affinityProcessors.size() > std::numeric_limits<uint32_t>::max())
+                {
+                    throw std::invalid_argument("Too many allowed processor entries");
+                }
+                k++;
+                if (k < allowed.size() && allowed[k].first == job)
+                {
+                    throw std::invalid_argument("Allowed processors of job " + std::to_string(job + 1) + " are given twice");
+                }
+            }
+        }
+        affinityOffsets[numJobs] = static_cast<uint32_t>(affinityProcessors.size());
+        if (k < allowed.size())
+        {
+            throw std::invalid_argument("Allowed processors given for unknown job " + std::to_string(allowed[k].first + 1));
+        }
+    }
+
+    int getNumProcessors() const { return numProcessors; }
+    int timeFactor(int processor) const { return timeFactors[processor]; }
+    long long getTimeScale() const { return timeScale; }
+
+    // Ограничена ли работа списком процессоров
+    bool isRestricted(int job) const
+    {
+        return !affinityOffsets.empty() && affinityOffsets[job] != affinityOffsets[job + 1];
+    }
+
+    bool isAllowed(int job, int processor) const
+    {
+        if (!isRestricted(job))
+        {
+            return true;
+        }
+        const int *begin = affinityProcessors.data() + affinityOffsets[job];
+        const int *end = affinityProcessors.data() + affinityOffsets[job + 1];
+        return std::binary_search(begin, end, processor);
+    }
+
+    // Равновероятный допустимый процессор ограниченной работы, отличный от current, или -1, если его нет.
+    // Одно случайное число: индекс r из первых k - 1 элементов списка, а если там стоит current,
+    // его место занимает последний элемент. current должен быть допустим для работы
+    int randomOtherAllowedProcessor(int job, int current, Xoshiro256 &rng) const
+    {
+        uint32_t begin = affinityOffsets[job];
+        uint32_t count = affinityOffsets[job + 1] - begin;
+        if (count < 2)
+        {
+            return -1;
+        }
+        int processor = affinityProcessors[begin + rng.uniformInt(count - 1)];
+        return processor == current ? affinityProcessors[begin + count - 1] : processor;
+    }
+
+    // Перенос работ, стоящих на недопустимых процессорах, на допустимый процессор с наименьшей
+    // (с учетом скорости) нагрузкой. Построители начального решения ограничений не знают,
+    // поэтому решение исправляет их назначение при создании. Возвращает количество перенесенных работ
+    int makeFeasible(std::vector<int> &assignment, const std::vector<uint8_t> &jobDurations) const
+    {
+        if (affinityOffsets.empty())
+        {
+            return 0;
+        }
+        std::vector<long long> loads(numProcessors, 0);
+        for (int job = 0; job < numJobs; ++job)
+        {
+            if (isAllowed(job, assignment[job]))
+            {
+                loads[assignment[job]] += static_cast<long long>(jobDurations[job]) * timeFactors[assignment[job]];
+            }
+        }
+        int moved = 0;
+        std::vector<long long> candidateLoads; // Нагрузки допустимых процессоров после переноса работы
+        for (int job = 0; job < numJobs; ++job)
+        {
+            if (isAllowed(job, assignment[job]))
+            {
+                continue;
+            }
+            uint32_t begin = affinityOffsets[job];
+            int count = static_cast<int>(affinityOffsets[job + 1] - begin);
+            candidateLoads.resize(count);
+            for (int k = 0; k < count; ++k)
+            {
+                int p = affinityProcessors[begin + k];
+                candidateLoads[k] = loads[p] + static_cast<long long>(jobDurations[job]) * timeFactors[p];
+            }
+            int best = affinityProcessors[begin + loadKernels().loadRange(candidateLoads.data(), count).minIndex];
+            assignment[job] = best;
+            loads[best] += static_cast<long long>(jobDurations[job]) * timeFactors[best];
+            moved++;
+        }
+        return moved;
+    }
+
+private:
+    int numJobs;
+    int numProcessors;
+    long long timeScale = 1;              // Тактов на единицу стоимости (1 без скоростей)
+    std::vector<int> timeFactors;         // Тактов на единицу длительности для каждого процессора
+    std::vector<uint32_t> affinityOffsets; // CSR: список работы j - [offsets[j], offsets[j + 1]); пусто без ограничений
+    std::vector<int> affinityProcessors;  // CSR: отсортированные допустимые процессоры
+};
+
+// Номер работы из файла ограничений: "Job_17" или "17" (нумерация с 1, как в CSV работ)
+inline int parseJobNumber(const std::string &text)
+{
+    std::string digits = text.rfind("Job_", 0) == 0 ? text.substr(4) : text;
+    size_t parsed = 0;
+    long long number = std::stoll(digits, &parsed);
+    if (parsed != digits.size() || number < 1 || number > std::numeric_limits<int>::max())
+    {
+        throw std::invalid_argument("invalid job '" + text + "'");
+    }
+    return static_cast<int>(number - 1);
+}
+
+// Загрузка модели процессоров из файлов командной строки:
+//   speedsFile   - скорости процессоров 0..P-1, числа через пробелы, запятые или переводы строк;
+//   affinityFile - строки "<job> <processor> <processor> ...", job - "Job_i" или i (с 1), процессоры с 0;
+//                  пустые строки и строки, начинающиеся с '#', пропускаются.
+// Пустое имя означает отсутствие соответствующей части; без обеих частей возвращается nullptr
+inline std::shared_ptr<const ProcessorModel> loadProcessorModel(int numJobs, int numProcessors, const std::string &speedsFile, const std::string &affinityFile)
+{
+    if (speedsFile.empty() && affinityFile.empty())
+    {
+        return nullptr;
+    }
+    auto model = std::make_shared<ProcessorModel>(numJobs, numProcessors);
+    if (!speedsFile.empty())
+    {
+        std::ifstream file(speedsFile);
+        if (!file)
+        {
+            throw std::runtime_error("Unable to open file " + speedsFile);
+        }
+        std::stringstream text;
+        text << file.rdbuf();
+        std::string content = text.str();
+        std::replace(content.begin(), content.end(), ',', ' ');
+        std::istringstream values(content);
+        std::vector<double> speeds;
+        std::string value;
+        while (values >> value)
+        {
+            speeds.push_back(std::stod(value));
+        }
+        model->setSpeeds(speeds);
+    }
+    if (!affinityFile.empty())
+    {
+        std::ifstream file(affinityFile);
+        if (!file)
+        {
+            throw std::runtime_error("Unable to open file " + affinityFile);
+        }
+        std::vector<std::pair<int, std::vector<int>>> allowed;
+        std::string line;
+        for (int lineNumber = 1; std::getline(file, line); ++lineNumber)
+        {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#')
+            {
+                continue;
+            }
+            try
+            {
+                std::istringstream fields(line);
+                std::string job;
+                fields >> job;
+                std::vector<int> processors;
+                std::string processor;
+                while (fields >> processor)
+                {
+                    processors.push_back(std::stoi(processor));
+                }
+                allowed.emplace_back(parseJobNumber(job), std::move(processors));
+            }
+            catch (const std::exception &e)
+            {
+                throw std::runtime_error(affinityFile + ":" + std::to_string(lineNumber) + ": " + e.what());
+            }
+        }
+        model->setAffinity(std::move(allowed));
+    }
+    return model;
+}
+
+#endif // PROCESSOR_MODEL_H
@@ -0,0 +1,116 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Поток событий улучшения решения в формате JSON Lines:
+// {"t": секунды от старта, "chain": номер цепочки, "iteration": итерация цепочки, "cost": стоимость}.
+// Цикл отжига только добавляет событие в буфер под коротким мьютексом; форматирование и запись
+// выполняет отдельный поток, который забирает буфер раз в flushInterval и при завершении.
+// Числа печатаются с точностью, достаточной для точного восстановления double
+class ProgressSink
+{
+public:
+    // path - имя файла или "-" для stderr
+    explicit ProgressSink(const std::string &path)
+        : start(std::chrono::steady_clock::now())
+    {
+        if (path == "-")
+        {
+            out = &std::cerr;
+        }
+        else
+        {
+            file = std::make_unique<std::ofstream>(path);
+            if (!*file)
+            {
+                throw std::runtime_error("Cannot open progress file: " + path);
+            }
+            out = file.get();
+        }
+        writer = std::thread([this]()
+                             { writerLoop(); });
+    }
+
+    ~ProgressSink()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_one();
+        writer.join();
+    }
+
+    ProgressSink(const ProgressSink &) = delete;
+    ProgressSink &operator=(const ProgressSink &) = delete;
+
+    // Вызывается из потоков отжига при улучшении
+    void record(int chain, long long iteration, double cost)
+    {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back({seconds, chain, iteration, cost});
+    }
+
+private:
+    struct Event
+    {
+        double seconds;
+        int chain;
+        long long iteration;
+        double cost;
+    };
+
+    static constexpr std::chrono::milliseconds flushInterval{100};
+
+    void writerLoop()
+    {
+        std::vector<Event> batch;
+        // Отдельный поток форматирования: точность не меняется у std::cerr, общего с остальным выводом
+        std::ostringstream text;
+        text.precision(std::numeric_limits<double>::max_digits10);
+        bool done = false;
+        while (!done)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait_for(lock, flushInterval, [this]()
+                                { return stopping; });
+                done = stopping;
+                batch.swap(pending);
+            }
+            text.str("");
+            for (const Event &event : batch)
+            {
+                text << "{\"t\":" << event.seconds << ",\"chain\":" << event.chain << ",\"iteration\":" << event.iteration
+                     << ",\"cost\":" << event.cost << "}\n";
+            }
+            *out << text.str();
+            out->flush();
+            batch.clear();
+        }
+    }
+
+    std::chrono::steady_clock::time_point start;
+    std::unique_ptr<std::ofstream> file;
+    std::ostream *out;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::vector<Event> pending; // Накопленные события (под mutex)
+    bool stopping = false;
+    std::thread writer;
+};
+
+#endif // PROGRESS_H
@@ -0,0 +1,173 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// Один шаг SplitMix64. Используется для разворачивания зерна в состояние генератора
+// и для вывода независимых зерен цепочек из одного главного зерна
+inline uint64_t splitMix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Детерминированное зерно цепочки chainId, полученное из главного зерна
+inline uint64_t deriveSeed(uint64_t masterSeed, uint64_t chainId)
+{
+    uint64_t state = masterSeed ^ (chainId * 0xD1B54A32D192ED03ULL);
+    splitMix64(state);
+    return splitMix64(state);
+}
+
+// Случайное главное зерно для прогона без --seed. Его нужно напечатать (см. seedManifest),
+// чтобы прогон можно было повторить
+inline uint64_t randomMasterSeed()
+{
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
+
+// Запись зерен прогона: главное зерно и выведенные из него зерна цепочек chainIds,
+// например "master=42 chain0=... chain1=...". Для повторения прогона достаточно главного зерна,
+// зерна цепочек позволяют сверить вывод зерен между сборками
+inline std::string seedManifest(uint64_t masterSeed, const std::vector<uint64_t> &chainIds)
+{
+    std::string text = "master=" + std::to_string(masterSeed);
+    for (uint64_t chainId : chainIds)
+    {
+        text += " chain" + std::to_string(chainId) + "=" + std::to_string(deriveSeed(masterSeed, chainId));
+    }
+    return text;
+}
+
+// Значения -ln(u) в узлах u = k / 2048, k = 0..2048, для быстрой экспоненциальной величины
+struct NegativeLogTable
+{
+    static constexpr int bits = 11;
+    static constexpr int size = 1 << bits;
+    float values[size + 1];
+
+    NegativeLogTable()
+    {
+        values[0] = std::numeric_limits<float>::infinity();
+        for (int k = 1; k <= size; ++k)
+        {
+            values[k] = static_cast<float>(-std::log(static_cast<double>(k) / size));
+        }
+    }
+};
+
+inline const NegativeLogTable negativeLogTable{};
+
+// Генератор xoshiro256** (Blackman, Vigna). Каждая цепочка отжига владеет своим экземпляром,
+// поэтому потокам не нужно разделять скрытое состояние, как у rand(), а прогон повторяется
+// побитово при том же зерне. Распределения реализованы здесь же, а не через <random>,
+// чтобы результат не зависел от реализации стандартной библиотеки
+class Xoshiro256
+{
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0)
+    {
+        this->seed(seed);
+    }
+
+    void seed(uint64_t seed)
+    {
+        for (uint64_t &word : state)
+        {
+            word = splitMix64(seed);
+        }
+    }
+
+    // Полное состояние генератора (для контрольных точек)
+    std::array<uint64_t, 4> getState() const
+    {
+        return {state[0], state[1], state[2], state[3]};
+    }
+
+    void setState(const std::array<uint64_t, 4> &words)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            state[i] = words[i];
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        const uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Равномерное целое из [0, bound) без смещения (метод Лемира)
+    uint32_t uniformInt(uint32_t bound)
+    {
+        uint64_t product = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound)
+        {
+            uint32_t threshold = -bound % bound;
+            while (low < threshold)
+            {
+                product = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // Равномерное вещественное из [0, 1)
+    double uniformReal()
+    {
+        return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+    // Стандартная экспоненциальная величина -ln(u), u ~ U[0, 1).
+    // Считается линейной интерполяцией по таблице вместо вызова log; для u < 16 / 2048,
+    // где кривизна логарифма велика, используется точный log (это 0.8% вызовов).
+    // Ошибка интерполяции не превышает 5e-4
+    double exponential()
+    {
+        uint64_t mantissa = (*this)() >> 11; // 53 случайных бита, u = mantissa * 2^-53
+        uint32_t bin = static_cast<uint32_t>(mantissa >> (53 - NegativeLogTable::bits));
+        if (bin < 16)
+        {
+            return mantissa == 0 ? std::numeric_limits<double>::infinity() : -std::log(static_cast<double>(mantissa) * 0x1.0p-53);
+        }
+        constexpr int fractionBits = 53 - NegativeLogTable::bits;
+        double fraction = static_cast<double>(mantissa & ((uint64_t(1) << fractionBits) - 1)) * (1.0 / (uint64_t(1) << fractionBits));
+        double low = negativeLogTable.values[bin];
+        double high = negativeLogTable.values[bin + 1];
+        return low + (high - low) * fraction;
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t state[4];
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,730 @@
+#ifndef SCHEDULING_H
+#define SCHEDULING_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "annealing.h"
+#include "checkpoint.h"
+#include "duration_index.h"
+#include "initial_solution.h"
+#include "load_kernels.h"
+#include "load_tree.h"
+#include "objective.h"
+#include "processor_model.h"
+#include "random.h"
+
+// Класс для представления решения задачи планирования
+class SchedulingSolution final : public Solution
+{
+public:
+    SchedulingSolution(int numJobs, int numProcessors, const std::vector<uint8_t> &jobDurations, Xoshiro256 &rng)
+        : SchedulingSolution(numJobs, numProcessors, jobDurations, randomAssignment(jobDurations, numProcessors, rng)) {}
+
+    // Решение с заданным начальным назначением (см. initial_solution.h), целевой функцией (см. objective.h)
+    // и моделью неоднородных процессоров (см. processor_model.h; nullptr - процессоры одинаковы и работы
+    // не ограничены). Работы, назначенные на недопустимые процессоры, переносятся на допустимые
+    SchedulingSolution(int numJobs, int numProcessors, const std::vector<uint8_t> &jobDurations, std::vector<int> initialAssignment,
+                       const SchedulingObjective &objective = SchedulingObjective(), std::shared_ptr<const ProcessorModel> processorModel = nullptr)
+        : numJobs(numJobs), numProcessors(numProcessors), jobDurations(jobDurations), assignment(std::move(initialAssignment)), objective(objective),
+          processorModel(std::move(processorModel)), timeScale(this->processorModel ? this->processorModel->getTimeScale() : 1)
+    {
+        if (this->processorModel)
+        {
+            this->processorModel->makeFeasible(assignment, jobDurations);
+        }
+        processorJobs.resize(numProcessors);
+        jobSlot.resize(numJobs);
+        for (int i = 0; i < numJobs; ++i)
+        {
+            jobSlot[i] = static_cast<int>(processorJobs[assignment[i]].size());
+            processorJobs[assignment[i]].push_back(i);
+        }
+        buildLoads();
+        durationIndex.build(numProcessors, jobDurations, assignment);
+    }
+
+    double getCost() const override
+    {
+        // По умолчанию критерий K1: разбалансированность расписания Tmax - Tmin.
+        // Экстремумы нагрузок поддерживаются деревом отрезков, а сумма квадратов - LoadMoments,
+        // поэтому вычисление любой целевой функции стоит O(1)
+        return objective.evaluate(processorLoads, loadMoments, timeScale);
+    }
+
+    // Значения отдельных критериев независимо от выбранной целевой функции (для отчетов)
+    double getImbalance() const { return (processorLoads.maxLoad() - processorLoads.minLoad()) / timeScale; }
+    double getMakespan() const { return processorLoads.maxLoad() / timeScale; }
+    double getLoadVariance() const { return loadMoments.variance() / (timeScale * timeScale); }
+    const SchedulingObjective &getObjective() const { return objective; }
+
+    void print() const override
+    {
+        // Печать нагрузки на каждом процессоре
+        // for (int i = 0; i < numProcessors; ++i)
+        // {
+        //     std::cout << "Processor " << i << ": Load = " << processorLoads[i] << std::endl;
+        // }
+    }
+
+    std::shared_ptr<Solution> clone() const override
+    {
+        // Создание копии текущего решения
+        return std::make_shared<SchedulingSolution>(*this);
+    }
+
+    void commit() override
+    {
+        // Изменения уже внесены в расписание; перемещения переходят из журнала отката
+        // в журнал с момента лучшего решения
+        bestJournal.insert(bestJournal.end(), pendingMoves.begin(), pendingMoves.end());
+        pendingMoves.clear();
+        if (bestJournal.size() > static_cast<size_t>(std::max(numJobs, 1024)))
+        {
+            compactBestJournal();
+        }
+    }
+
+    void rollback() override
+    {
+        // Откатываем перемещения в обратном порядке
+        for (auto it = pendingMoves.rbegin(); it != pendingMoves.rend(); ++it)
+        {
+            moveJob(it->jobIndex, it->newProcessor, it->oldProcessor);
+        }
+        pendingMoves.clear();
+    }
+
+    void markBest() override
+    {
+        bestJournal.clear();
+        bestAssignment.clear();
+    }
+
+    void restoreBest() override
+    {
+        rollback();
+        if (bestAssignment.empty())
+        {
+            // Лучшее состояние восстанавливается обратным проходом по журналу
+            for (auto it = bestJournal.rbegin(); it != bestJournal.rend(); ++it)
+            {
+                moveJob(it->jobIndex, it->newProcessor, it->oldProcessor);
+            }
+        }
+        else
+        {
+            // Журнал был сжат в снимок назначения: переносим работы, стоящие не на своих местах
+            for (int i = 0; i < numJobs; ++i)
+            {
+                if (assignment[i] != bestAssignment[i])
+                {
+                    moveJob(i, assignment[i], bestAssignment[i]);
+                }
+            }
+        }
+        markBest();
+    }
+
+    void saveState(CheckpointWriter &writer) const override
+    {
+        if (!pendingMoves.empty())
+        {
+            throw std::logic_error("Cannot checkpoint a solution with uncommitted moves");
+        }
+        // Испорченное инкрементальное состояние не должно попасть в контрольную точку
+        verifyLoads(computeLoads());
+        // Назначение задается списками работ процессоров. Порядок в списках и в корзинах индекса
+        // длительностей определяет, какие работы выбирают ходы, поэтому сохраняется как есть
+        writer.put<int32_t>(numJobs);
+        writer.put<int32_t>(numProcessors);
+        for (const std::vector<int> &jobs : processorJobs)
+        {
+            writer.putVector(jobs);
+        }
+        writer.putVector(durationIndex.bucketOrder());
+        writer.putVector(bestJournal);
+        writer.putVector(bestAssignment);
+    }
+
+    void loadState(CheckpointReader &reader) override
+    {
+        if (reader.get<int32_t>() != numJobs || reader.get<int32_t>() != numProcessors)
+        {
+            throw std::runtime_error("Checkpoint does not match the number of jobs or processors");
+        }
+        std::vector<std::vector<int>> lists(numProcessors);
+        std::vector<int> newAssignment(numJobs, -1);
+        std::vector<int> newSlots(numJobs);
+        for (int p = 0; p < numProcessors; ++p)
+        {
+            lists[p] = reader.getVector<int>();
+            for (size_t k = 0; k < lists[p].size(); ++k)
+            {
+                int job = lists[p][k];
+                if (job < 0 || job >= numJobs || newAssignment[job] >= 0)
+                {
+                    throw std::runtime_error("Checkpoint has an invalid job list");
+                }
+                newAssignment[job] = p;
+                newSlots[job] = static_cast<int>(k);
+            }
+        }
+        std::vector<int> order = reader.getVector<int>();
+        std::vector<JobMove> journal = reader.getVector<JobMove>();
+        std::vector<int> snapshot = reader.getVector<int>();
+        bool valid = std::find(newAssignment.begin(), newAssignment.end(), -1) == newAssignment.end() &&
+                     order.size() == static_cast<size_t>(numJobs) && (snapshot.empty() || snapshot.size() == static_cast<size_t>(numJobs));
+        std::vector<char> seen(numJobs, 0);
+        for (size_t k = 0; valid && k < order.size(); ++k)
+        {
+            valid = order[k] >= 0 && order[k] < numJobs && !seen[order[k]];
+            if (valid)
+            {
+                seen[order[k]] = 1;
+            }
+        }
+        for (const JobMove &move : journal)
+        {
+            valid = valid && move.jobIndex >= 0 && move.jobIndex < numJobs && move.oldProcessor >= 0 && move.oldProcessor < numProcessors &&
+                    move.newProcessor >= 0 && move.newProcessor < numProcessors;
+        }
+        for (int p : snapshot)
+        {
+            valid = valid && p >= 0 && p < numProcessors;
+        }
+        if (!valid)
+        {
+            throw std::runtime_error("Checkpoint has an invalid solution state");
+        }
+
+        assignment = std::move(newAssignment);
+        processorJobs = std::move(lists);
+        jobSlot = std::move(newSlots);
+        buildLoads();
+        durationIndex.build(numProcessors, jobDurations, assignment, order);
+        pendingMoves.clear();
+        bestJournal = std::move(journal);
+        bestAssignment = std::move(snapshot);
+    }
+
+    void updateSchedule(int jobIndex, int oldProcessor, int newProcessor)
+    {
+        // Перемещаем работу и запоминаем перемещение для возможного отката
+        moveJob(jobIndex, oldProcessor, newProcessor);
+        pendingMoves.push_back({jobIndex, oldProcessor, newProcessor});
+    }
+
+    int getNumJobs() const { return numJobs; }
+    int getNumProcessors() const { return numProcessors; }
+    int getJobProcessor(int jobIndex) const { return assignment[jobIndex]; }
+    int getJobDuration(int jobIndex) const { return jobDurations[jobIndex]; }
+    // Работы процессора в произвольном порядке: k-я работа за O(1), k < getProcessorJobCount
+    int getProcessorJobCount(int processor) const { return static_cast<int>(processorJobs[processor].size()); }
+    int getProcessorJob(int processor, int k) const { return processorJobs[processor][k]; }
+    const std::vector<int> &getAssignment() const { return assignment; }
+    const LoadExtremesTree &getProcessorLoads() const { return processorLoads; }
+    const DurationIndex &getDurationIndex() const { return durationIndex; }
+    // Модель неоднородных процессоров или nullptr для одинаковых процессоров без ограничений
+    const ProcessorModel *getProcessorModel() const { return processorModel.get(); }
+    // Тактов нагрузки на единицу длительности работы на процессоре (1 для одинаковых процессоров)
+    int getTimeFactor(int processor) const { return processorModel ? processorModel->timeFactor(processor) : 1; }
+    bool isAllowed(int jobIndex, int processor) const { return !processorModel || processorModel->isAllowed(jobIndex, processor); }
+    // Время выполнения работы на процессоре в единицах нагрузки
+    long long processingTime(int jobIndex, int processor) const
+    {
+        return processorModel ? static_cast<long long>(jobDurations[jobIndex]) * processorModel->timeFactor(processor) : jobDurations[jobIndex];
+    }
+
+    // Построение матрицы расписания (работа x процессор) для отчетов.
+    // Матрица не хранится в решении и создается только по запросу
+    std::vector<std::vector<uint8_t>> exportScheduleMatrix() const
+    {
+        std::vector<std::vector<uint8_t>> schedule(numJobs, std::vector<uint8_t>(numProcessors, 0));
+        for (int i = 0; i < numJobs; ++i)
+        {
+            schedule[i][assignment[i]] = 1;
+        }
+        return schedule;
+    }
+
+private:
+    // Перемещение одной работы между процессорами
+    struct JobMove
+    {
+        int jobIndex;
+        int oldProcessor;
+        int newProcessor;
+    };
+
+    // Когда журнал с момента лучшего решения становится длиннее числа работ, лучшее назначение
+    // сохраняется снимком, а журнал очищается. Поэтому и память, и время на перемещение - O(1) в среднем
+    void compactBestJournal()
+    {
+        if (bestAssignment.empty())
+        {
+            bestAssignment = assignment;
+            for (auto it = bestJournal.rbegin(); it != bestJournal.rend(); ++it)
+            {
+                bestAssignment[it->jobIndex] = it->oldProcessor;
+            }
+        }
+        bestJournal.clear();
+    }
+
+    // Полный пересчет нагрузок по назначению векторным ядром гистограммы (load_kernels.h).
+    // Время работы на процессоре - длительность, умноженная на его коэффициент, поэтому
+    // гистограмма считается по длительностям и масштабируется один раз на процессор
+    std::vector<long long> computeLoads() const
+    {
+        std::vector<long long> loads(numProcessors, 0);
+        loadKernels().accumulateLoads(assignment.data(), jobDurations.data(), numJobs, numProcessors, loads.data());
+        for (int p = 0; processorModel && p < numProcessors; ++p)
+        {
+            loads[p] *= processorModel->timeFactor(p);
+        }
+        return loads;
+    }
+
+    // Построение нагрузок (создание решения, загрузка контрольной точки)
+    void buildLoads()
+    {
+        std::vector<long long> loads = computeLoads();
+        processorLoads.build(loads);
+        loadMoments.build(loads);
+    }
+
+    // Сверка нагрузок с пересчетом: значения листьев дерева - с гистограммой, экстремумы в корне
+    // дерева - с векторным поиском экстремумов. Расхождение - ошибка в инкрементальном обновлении
+    void verifyLoads(const std::vector<long long> &loads) const
+    {
+        LoadRange range = loadKernels().loadRange(loads.data(), numProcessors);
+        if (loads != processorLoads.values() || loads[range.minIndex] != processorLoads.minLoad() || loads[range.maxIndex] != processorLoads.maxLoad())
+        {
+            throw std::logic_error("Processor loads do not match the assignment");
+        }
+    }
+
+    void moveJob(int jobIndex, int oldProcessor, int newProcessor)
+    {
+        // Обновляем нагрузку процессоров и назначение работы
+        assignment[jobIndex] = newProcessor; // Перемещаем работу на новый процессор
+        if (processorModel)
+        {
+            long long oldTime = processingTime(jobIndex, oldProcessor);
+            long long newTime = processingTime(jobIndex, newProcessor);
+            loadMoments.move(processorLoads[oldProcessor], oldTime, processorLoads[newProcessor], newTime);
+            processorLoads.add(oldProcessor, -oldTime);
+            processorLoads.add(newProcessor, newTime);
+        }
+        else
+        {
+            // Одинаковые процессоры: время работы равно ее длительности
+            loadMoments.move(processorLoads[oldProcessor], processorLoads[newProcessor], jobDurations[jobIndex]);
+            processorLoads.add(oldProcessor, -jobDurations[jobIndex]);
+            processorLoads.add(newProcessor, jobDurations[jobIndex]);
+        }
+
+        // Удаляем работу из списка старого процессора, ставя на ее место последнюю работу списка
+        std::vector<int> &from = processorJobs[oldProcessor];
+        int slot = jobSlot[jobIndex];
+        from[slot] = from.back();
+        jobSlot[from[slot]] = slot;
+        from.pop_back();
+        jobSlot[jobIndex] = static_cast<int>(processorJobs[newProcessor].size());
+        processorJobs[newProcessor].push_back(jobIndex);
+
+        durationIndex.erase(oldProcessor, jobIndex, jobDurations[jobIndex]);
+        durationIndex.insert(newProcessor, jobIndex, jobDurations[jobIndex]);
+    }
+
+    int numJobs;                                     // Количество работ
+    int numProcessors;                               // Количество процессоров
+    std::vector<uint8_t> jobDurations;               // Длительности работ
+    std::vector<int> assignment;                     // Назначение работ: номер процессора для каждой работы
+    SchedulingObjective objective;                   // Целевая функция
+    std::shared_ptr<const ProcessorModel> processorModel; // Скорости и допустимые процессоры (nullptr - одинаковые процессоры)
+    double timeScale;                                // Единиц нагрузки в единице стоимости
+    LoadExtremesTree processorLoads;                 // Нагрузки на процессоры с поддержкой максимума и минимума
+    LoadMoments loadMoments;                         // Сумма квадратов нагрузок для дисперсии
+    std::vector<std::vector<int>> processorJobs;     // Списки работ каждого процессора
+    std::vector<int> jobSlot;                        // Позиция работы в списке ее процессора
+    DurationIndex durationIndex;                     // Работы каждого процессора по длительностям
+    std::vector<JobMove> pendingMoves;               // Журнал незафиксированных перемещений
+    std::vector<JobMove> bestJournal;                // Зафиксированные перемещения после лучшего решения
+    std::vector<int> bestAssignment;                 // Снимок лучшего назначения (пуст, пока хватает журнала)
+};
+
+// Ходы окрестности решения задачи планирования
+enum class MoveKind
+{
+    Move,      // Случайная работа на случайный другой процессор
+    Swap,      // Обмен работами самого загруженного и самого свободного процессоров с разностью длительностей около (Tmax - Tmin) / 2
+    KExchange, // Циклический сдвиг работ между самым загруженным и двумя случайными процессорами
+    Targeted,  // Перенос с самого загруженного процессора на самый свободный работы длительностью около (Tmax - Tmin) / 2
+    Batch      // Лучший из пакета случайных переносов работ с самого загруженного процессора
+};
+
+inline const char *moveKindName(MoveKind move)
+{
+    switch (move)
+    {
+    case MoveKind::Move:
+        return "move";
+    case MoveKind::Swap:
+        return "swap";
+    case MoveKind::KExchange:
+        return "kexchange";
+    case MoveKind::Targeted:
+        return "targeted";
+    case MoveKind::Batch:
+        return "batch";
+    }
+    return "unknown";
+}
+
+// Разбор списка ходов из командной строки: "move", "swap", "kexchange", "targeted", "batch"
+// через запятую или "adaptive" для первых четырех ходов сразу
+inline std::vector<MoveKind> parseMoveKinds(const std::string &spec)
+{
+    if (spec == "adaptive")
+    {
+        return {MoveKind::Move, MoveKind::Swap, MoveKind::KExchange, MoveKind::Targeted};
+    }
+    std::vector<MoveKind> moves;
+    size_t begin = 0;
+    while (begin <= spec.size())
+    {
+        size_t end = std::min(spec.find(',', begin), spec.size());
+        std::string name = spec.substr(begin, end - begin);
+        if (name == "move")
+        {
+            moves.push_back(MoveKind::Move);
+        }
+        else if (name == "swap")
+        {
+            moves.push_back(MoveKind::Swap);
+        }
+        else if (name == "kexchange")
+        {
+            moves.push_back(MoveKind::KExchange);
+        }
+        else if (name == "targeted")
+        {
+            moves.push_back(MoveKind::Targeted);
+        }
+        else if (name == "batch")
+        {
+            moves.push_back(MoveKind::Batch);
+        }
+        else
+        {
+            throw std::invalid_argument("Invalid move '" + name + "'. Available moves: move, swap, kexchange, targeted, batch, adaptive");
+        }
+        begin = end + 1;
+    }
+    return moves;
+}
+
+// Класс для операции мутации решения задачи планирования.
+// Если разрешено несколько ходов, ход выбирается рулеткой, вероятности которой подстраиваются
+// методом adaptive pursuit (Thierens): вероятность хода с наибольшей оценкой полезности тянется к pMax,
+// остальных - к pMin. Полезность хода - доля ходов, уменьшивших стоимость. Стоимость до и после хода
+// считается за O(1), а сам ход стоит O(log P), поэтому оценка не требует полного пересчета.
+// Объект хранит статистику выбора, поэтому у каждой цепочки должна быть своя копия
+class SchedulingMutation final : public MutationOperation
+{
+public:
+    explicit SchedulingMutation(std::vector<MoveKind> moves = {MoveKind::Move})
+        : moves(std::move(moves))
+    {
+        int count = static_cast<int>(this->moves.size());
+        probabilities.assign(count, 1.0 / count);
+        qualities.assign(count, 0.0);
+        pMin = count > 1 ? 0.2 / count : 1.0;
+        pMax = 1.0 - (count - 1) * pMin;
+    }
+
+    void mutate(Solution &solution, Xoshiro256 &rng) override
+    {
+        mutate(dynamic_cast<SchedulingSolution &>(solution), rng);
+    }
+
+    // Невиртуальная перегрузка для шаблонного цикла отжига: без dynamic_cast и косвенного вызова
+    void mutate(SchedulingSolution &schedSolution, Xoshiro256 &rng)
+    {
+        if (moves.size() == 1)
+        {
+            apply(moves[0], schedSolution, rng);
+            return;
+        }
+
+        // Выбор хода рулеткой
+        double r = rng.uniformReal();
+        int chosen = 0;
+        while (chosen + 1 < static_cast<int>(moves.size()) && r >= probabilities[chosen])
+        {
+            r -= probabilities[chosen];
+            chosen++;
+        }
+
+        double before = schedSolution.getCost();
+        apply(moves[chosen], schedSolution, rng);
+        double reward = schedSolution.getCost() < before ? 1.0 : 0.0;
+
+        // Adaptive pursuit: оценка полезности и подтягивание вероятностей к лучшему ходу
+        qualities[chosen] += learningRate * (reward - qualities[chosen]);
+        int best = static_cast<int>(std::max_element(qualities.begin(), qualities.end()) - qualities.begin());
+        for (size_t i = 0; i < moves.size(); ++i)
+        {
+            double target = static_cast<int>(i) == best ? pMax : pMin;
+            probabilities[i] += learningRate * (target - probabilities[i]);
+        }
+    }
+
+    void saveState(CheckpointWriter &writer) const override
+    {
+        std::vector<uint8_t> kinds;
+        for (MoveKind move : moves)
+        {
+            kinds.push_back(static_cast<uint8_t>(move));
+        }
+        writer.putVector(kinds);
+        writer.putVector(probabilities);
+        writer.putVector(qualities);
+    }
+
+    void loadState(CheckpointReader &reader) override
+    {
+        std::vector<uint8_t> kinds = reader.getVector<uint8_t>();
+        bool sameMoves = kinds.size() == moves.size();
+        for (size_t i = 0; sameMoves && i < moves.size(); ++i)
+        {
+            sameMoves = kinds[i] == static_cast<uint8_t>(moves[i]);
+        }
+        if (!sameMoves)
+        {
+            throw std::runtime_error("Checkpoint was written with a different set of moves (--moves)");
+        }
+        probabilities = reader.getVector<double>();
+        qualities = reader.getVector<double>();
+        if (probabilities.size() != moves.size() || qualities.size() != moves.size())
+        {
+            throw std::runtime_error("Checkpoint has an invalid mutation state");
+        }
+    }
+
+    const std::vector<MoveKind> &getMoves() const { return moves; }
+    const std::vector<double> &getProbabilities() const { return probabilities; }
+
+private:
+    void apply(MoveKind move, SchedulingSolution &schedSolution, Xoshiro256 &rng)
+    {
+        if (schedSolution.getNumProcessors() < 2)
+        {
+            return; // Ходов нет: решение остается без изменений
+        }
+        switch (move)
+        {
+        case MoveKind::Move:
+            randomMove(schedSolution, rng);
+            break;
+        case MoveKind::Swap:
+            swapMove(schedSolution, rng);
+            break;
+        case MoveKind::KExchange:
+            kExchangeMove(schedSolution, rng);
+            break;
+        case MoveKind::Targeted:
+            targetedMove(schedSolution, rng);
+            break;
+        case MoveKind::Batch:
+            batchMove(schedSolution, rng);
+            break;
+        }
+    }
+
+    static void randomMove(SchedulingSolution &schedSolution, Xoshiro256 &rng)
+    {
+        int numProcessors = schedSolution.getNumProcessors();
+
+        int jobIndex = rng.uniformInt(schedSolution.getNumJobs()); // Выбираем случайную работу
+        int oldProcessor = schedSolution.getJobProcessor(jobIndex);
+        const ProcessorModel *model = schedSolution.getProcessorModel();
+        int newProcessor;
+        if (model && model->isRestricted(jobIndex))
+        {
+            // Ограниченная работа переносится только на свой допустимый процессор
+            newProcessor = model->randomOtherAllowedProcessor(jobIndex, oldProcessor, rng);
+            if (newProcessor < 0)
+            {
+                return; // Работа закреплена за единственным процессором
+            }
+        }
+        else
+        {
+            newProcessor = rng.uniformInt(numProcessors); // Выбираем новый случайный процессор
+            while (newProcessor == oldProcessor)
+            {
+                newProcessor = rng.uniformInt(numProcessors); // Убеждаемся, что новый процессор отличается от старого
+            }
+        }
+
+        schedSolution.updateSchedule(jobIndex, oldProcessor, newProcessor); // Обновляем расписание
+    }
+
+    // Длительность работы, перенос которой с самого загруженного процессора на самый свободный лучше всего
+    // выравнивает пару: перенос длительности d меняет разрыв на |gap - d (cMax + cMin)|, где c - такты
+    // нагрузки на единицу длительности. Для одинаковых процессоров это gap / 2
+    static int balancingDuration(const SchedulingSolution &schedSolution, int maxProcessor, int minProcessor)
+    {
+        const LoadExtremesTree &loads = schedSolution.getProcessorLoads();
+        long long perDuration = schedSolution.getTimeFactor(maxProcessor) + schedSolution.getTimeFactor(minProcessor);
+        return static_cast<int>(std::min<long long>((loads.maxLoad() - loads.minLoad()) / perDuration, DurationIndex::numDurations));
+    }
+
+    // Случайная работа процессора или -1, если процессор пуст
+    static int randomJobOf(const SchedulingSolution &schedSolution, int processor, Xoshiro256 &rng)
+    {
+        int count = schedSolution.getProcessorJobCount(processor);
+        return count > 0 ? schedSolution.getProcessorJob(processor, rng.uniformInt(count)) : -1;
+    }
+
+    static void swapMove(SchedulingSolution &schedSolution, Xoshiro256 &rng)
+    {
+        const LoadExtremesTree &loads = schedSolution.getProcessorLoads();
+        int maxProcessor = loads.maxProcessor();
+        int minProcessor = loads.minProcessor();
+        if (maxProcessor == minProcessor)
+        {
+            randomMove(schedSolution, rng); // Все нагрузки равны
+            return;
+        }
+        // Обмен работ длительностей a (с загруженного) и b (со свободного) сокращает разрыв пары
+        // на 2 (a - b), поэтому к случайной работе b подбирается работа с длительностью около b + gap / 2.
+        // Перемещение, недопустимое для работы, пропускается
+        int fromMin = randomJobOf(schedSolution, minProcessor, rng);
+        int wanted = (fromMin >= 0 ? schedSolution.getJobDuration(fromMin) : 0) + balancingDuration(schedSolution, maxProcessor, minProcessor);
+        int fromMax = schedSolution.getDurationIndex().closestJob(maxProcessor, wanted);
+        if (fromMax >= 0 && schedSolution.isAllowed(fromMax, minProcessor))
+        {
+            schedSolution.updateSchedule(fromMax, maxProcessor, minProcessor);
+        }
+        if (fromMin >= 0 && schedSolution.isAllowed(fromMin, maxProcessor))
+        {
+            schedSolution.updateSchedule(fromMin, minProcessor, maxProcessor);
+        }
+    }
+
+    static void kExchangeMove(SchedulingSolution &schedSolution, Xoshiro256 &rng)
+    {
+        int numProcessors = schedSolution.getNumProcessors();
+        if (numProcessors < 3)
+        {
+            swapMove(schedSolution, rng);
+            return;
+        }
+        // Процессоры цикла: самый загруженный и два случайных различных
+        int cycle[3];
+        cycle[0] = schedSolution.getProcessorLoads().maxProcessor();
+        do
+        {
+            cycle[1] = rng.uniformInt(numProcessors);
+        } while (cycle[1] == cycle[0]);
+        do
+        {
+            cycle[2] = rng.uniformInt(numProcessors);
+        } while (cycle[2] == cycle[0] || cycle[2] == cycle[1]);
+
+        // Работы выбираются до перемещений, чтобы ни одна не сдвинулась дважды
+        int jobs[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            jobs[k] = randomJobOf(schedSolution, cycle[k], rng);
+        }
+        for (int k = 0; k < 3; ++k)
+        {
+            if (jobs[k] >= 0 && schedSolution.isAllowed(jobs[k], cycle[(k + 1) % 3]))
+            {
+                schedSolution.updateSchedule(jobs[k], cycle[k], cycle[(k + 1) % 3]);
+            }
+        }
+    }
+
+    static void targetedMove(SchedulingSolution &schedSolution, Xoshiro256 &rng)
+    {
+        const LoadExtremesTree &loads = schedSolution.getProcessorLoads();
+        int maxProcessor = loads.maxProcessor();
+        int minProcessor = loads.minProcessor();
+        // Перенос работы длительности d меняет разрыв пары на |gap - 2d|, лучший выбор d = gap / 2.
+        // Индекс длительностей сразу дает работу с ближайшей длительностью вместо выборки с отказами
+        int job = schedSolution.getDurationIndex().closestJob(maxProcessor, balancingDuration(schedSolution, maxProcessor, minProcessor));
+        if (maxProcessor == minProcessor || job < 0 || !schedSolution.isAllowed(job, minProcessor))
+        {
+            randomMove(schedSolution, rng);
+            return;
+        }
+        schedSolution.updateSchedule(job, maxProcessor, minProcessor);
+    }
+
+    // Пакет - один вектор AVX-512 64-битных нагрузок (см. load_kernels.h)
+    static constexpr int batchMoveCandidates = 8;
+
+    // Несколько предложений за итерацию: случайные работы самого загруженного процессора, каждая со своим
+    // случайным допустимым процессором назначения. Кандидат оценивается наибольшей из нагрузок пары
+    // после переноса, и применяется кандидат с наименьшей оценкой; оценка пакета - одно векторное ядро
+    static void batchMove(SchedulingSolution &schedSolution, Xoshiro256 &rng)
+    {
+        const LoadExtremesTree &loads = schedSolution.getProcessorLoads();
+        const ProcessorModel *model = schedSolution.getProcessorModel();
+        int numProcessors = schedSolution.getNumProcessors();
+        int maxProcessor = loads.maxProcessor();
+        int jobs[batchMoveCandidates];
+        int targets[batchMoveCandidates];
+        long long sourceLoads[batchMoveCandidates];
+        long long targetLoads[batchMoveCandidates];
+        for (int k = 0; k < batchMoveCandidates; ++k)
+        {
+            int job = randomJobOf(schedSolution, maxProcessor, rng);
+            int target = -1;
+            if (job >= 0 && model && model->isRestricted(job))
+            {
+                target = model->randomOtherAllowedProcessor(job, maxProcessor, rng);
+            }
+            else if (job >= 0)
+            {
+                // Равновероятный процессор, отличный от maxProcessor, одним случайным числом
+                target = rng.uniformInt(numProcessors - 1);
+                target += target >= maxProcessor ? 1 : 0;
+            }
+            jobs[k] = target >= 0 ? job : -1;
+            targets[k] = target;
+            // Невозможный кандидат получает наихудшую оценку
+            sourceLoads[k] = target >= 0 ? loads.maxLoad() - schedSolution.processingTime(job, maxProcessor) : std::numeric_limits<long long>::max();
+            targetLoads[k] = target >= 0 ? loads[target] + schedSolution.processingTime(job, target) : std::numeric_limits<long long>::max();
+        }
+        int best = loadKernels().argMinOfMax(sourceLoads, targetLoads, batchMoveCandidates);
+        if (jobs[best] < 0)
+        {
+            randomMove(schedSolution, rng);
+            return;
+        }
+        schedSolution.updateSchedule(jobs[best], maxProcessor, targets[best]);
+    }
+
+    static constexpr double learningRate = 0.05;
+
+    std::vector<MoveKind> moves;       // Разрешенные ходы
+    std::vector<double> probabilities; // Вероятности выбора ходов
+    std::vector<double> qualities;     // Оценки полезности ходов
+    double pMin;                       // Нижняя граница вероятности хода
+    double pMax;                       // Верхняя граница вероятности хода
+};
+
+#endif // SCHEDULING_H
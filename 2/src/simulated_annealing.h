@@ -0,0 +1,266 @@
+#ifndef SIMULATED_ANNEALING_H
+#define SIMULATED_ANNEALING_H
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include "annealing.h"
+#include "checkpoint.h"
+#include "instrumentation.h"
+#include "progress.h"
+#include "random.h"
+
+// Основной класс для алгоритма имитации отжига.
+// Типы решения, мутации и закона охлаждения - параметры шаблона: для конкретных (final) классов
+// все вызовы в цикле разрешаются при компиляции и встраиваются. С базовыми классами
+// Solution / MutationOperation / CoolingSchedule шаблон работает через виртуальные вызовы
+template <typename SolutionT, typename MutationT, typename CoolingT>
+class SimulatedAnnealing
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    SimulatedAnnealing(SolutionT *solution, MutationT *mutationOperation, const CoolingT *coolingSchedule, double initialTemperature, int maxIterations, int maxNoImprovementCount, const Xoshiro256 &rng)
+        : solution(solution), mutationOperation(mutationOperation), coolingSchedule(coolingSchedule), initialTemperature(initialTemperature), maxIterations(maxIterations), maxNoImprovementCount(maxNoImprovementCount), rng(rng) {}
+
+    // Режим с ограничением времени: цепочки перезапускаются от лучшего решения до наступления срока
+    void setDeadline(Clock::time_point value)
+    {
+        deadline = value;
+        timeLimited = true;
+    }
+
+    // Приемник событий улучшения (может отсутствовать)
+    void setProgress(ProgressSink *sink)
+    {
+        progress = sink;
+    }
+
+    // Стоимость, время достижения которой измеряется (см. getTimeToTarget)
+    void setTargetCost(double cost)
+    {
+        targetCost = cost;
+    }
+
+    // Периодические контрольные точки: не чаще раза в intervalSeconds и с долей времени на снимок
+    // не больше 1 / CheckpointTimer::maxOverheadFactor. Сериализацию и запись выполняет поток sink
+    void setCheckpoint(CheckpointSink *sink, double intervalSeconds)
+    {
+        checkpoints = sink;
+        checkpointTimer = CheckpointTimer(intervalSeconds);
+    }
+
+    // Продолжение прогона из контрольной точки: восстанавливаются счетчики, текущая цепочка,
+    // генератор, решение и мутация. Следующий run продолжает побитово так же, как прерванный
+    void resume(CheckpointReader &reader)
+    {
+        bestCost = reader.get<double>();
+        totalIterations = reader.get<long long>();
+        chains = reader.get<int>();
+        resumedChain.iteration = reader.get<int32_t>();
+        resumedChain.temperature = reader.get<double>();
+        resumedChain.noImprovementCount = reader.get<int32_t>();
+        previousSeconds = reader.get<double>();
+        rng.setState(reader.get<std::array<uint64_t, 4>>());
+        double currentCost = reader.get<double>();
+        mutationOperation->loadState(reader);
+        solution->loadState(reader);
+        if (!reader.atEnd())
+        {
+            throw std::runtime_error("Checkpoint has unexpected trailing data");
+        }
+        if (solution->getCost() != currentCost)
+        {
+            throw std::runtime_error("Checkpoint does not match the objective or processor model of this run");
+        }
+        resumed = true;
+    }
+
+    void run()
+    {
+        // Температуры всех итераций считаются заранее одним пакетом
+        TemperatureTable<CoolingT> temperatures(*coolingSchedule, initialTemperature, maxIterations);
+        start = Clock::now();
+        if (!resumed)
+        {
+            bestCost = solution->getCost(); // Изначальная стоимость решения
+            solution->markBest();
+            report(0);
+        }
+        do
+        {
+            // Первая цепочка после возобновления продолжается с места контрольной точки
+            runChain(temperatures, resumed ? resumedChain : ChainState{0, initialTemperature, 0});
+            resumed = false;
+            chains++;
+            // Цепочка заканчивается в текущем, а не в лучшем состоянии
+            solution->restoreBest();
+        } while (timeLimited && Clock::now() < deadline);
+        seconds = previousSeconds + std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    double getBestCost() const { return bestCost; }
+    long long getIterations() const { return totalIterations; }
+    int getChains() const { return chains; }
+    // Время работы run в секундах, без построения таблицы температур (вместе с прогоном до контрольной точки)
+    double getSeconds() const { return seconds; }
+    // Секунды от начала run до первого решения со стоимостью не выше целевой или -1
+    double getTimeToTarget() const { return timeToTarget; }
+
+private:
+    // Срок и необходимость контрольной точки проверяются раз в deadlineCheckInterval итераций,
+    // чтобы не читать часы на каждом шаге
+    static constexpr int deadlineCheckInterval = 1024;
+
+    // Положение внутри цепочки
+    struct ChainState
+    {
+        int iteration;
+        double temperature;
+        int noImprovementCount;
+    };
+
+    void runChain(const TemperatureTable<CoolingT> &temperatures, ChainState chain)
+    {
+        double temperature = chain.temperature;
+        int iteration = chain.iteration;
+        int noImprovementCount = chain.noImprovementCount; // Счетчик количества итераций без улучшения
+
+        while (iteration < maxIterations && noImprovementCount < maxNoImprovementCount)
+        {
+            if (iteration % deadlineCheckInterval == 0 && (timeLimited || checkpoints))
+            {
+                Clock::time_point now = Clock::now();
+                if (timeLimited && now >= deadline)
+                {
+                    break;
+                }
+                if (checkpoints && checkpointTimer.due(now))
+                {
+                    saveCheckpoint({iteration, temperature, noImprovementCount}, now);
+                }
+            }
+            // Применяем мутацию к решению на месте, без копирования всего расписания
+            ANNEALING_COUNT(Iterations);
+            ANNEALING_TIMED(Mutate, mutationOperation->mutate(*solution, rng));
+            double currentCost = ANNEALING_TIMED(Cost, solution->getCost()); // Стоимость мутированного решения
+            if (currentCost < bestCost)
+            {
+                // Если новое решение лучше, фиксируем мутацию и запоминаем его как лучшее
+                ANNEALING_COUNT(Improvements);
+                bestCost = currentCost;
+                noImprovementCount = 0;
+                ANNEALING_TIMED(Commit, solution->commit());
+                solution->markBest();
+                report(totalIterations + iteration + 1);
+            }
+            else
+            {
+                // Если решение хуже, то принимаем его с некоторой вероятностью (правило Метрополиса)
+                if (ANNEALING_TIMED(Accept, metropolisAccept(currentCost - bestCost, temperature, rng)))
+                {
+                    // Принять ухудшающее решение и зафиксировать мутацию
+                    ANNEALING_COUNT(AcceptedWorse);
+                    noImprovementCount = 0;
+                    ANNEALING_TIMED(Commit, solution->commit());
+                }
+                else
+                {
+                    // Если решение не принято, откатываем мутацию и увеличиваем счетчик итераций без улучшений
+                    ANNEALING_COUNT(Rejected);
+                    ANNEALING_TIMED(Rollback, solution->rollback());
+                    noImprovementCount++;
+                }
+            }
+            // Обновляем температуру согласно закону понижения температуры
+            iteration++;
+            temperature = temperatures.at(iteration, temperature);
+        }
+        totalIterations += iteration;
+    }
+
+    // Снимок состояния между итерациями (незафиксированных ходов нет) и передача потоку записи.
+    // Счетчики и небольшое состояние мутации записываются сразу, а решение копируется в один из двух
+    // буферов (копирующее присваивание переиспользует память буфера) и сериализуется потоком записи,
+    // пока цепочка идет дальше. Пока поток не взял предыдущую точку, снимок откладывается
+    void saveCheckpoint(const ChainState &chain, Clock::time_point now)
+    {
+        if (!checkpoints->ready())
+        {
+            return;
+        }
+        CheckpointWriter writer;
+        writer.put(bestCost);
+        writer.put(totalIterations);
+        writer.put(chains);
+        // Поля по одному: в самой структуре есть байты выравнивания
+        writer.put<int32_t>(chain.iteration);
+        writer.put(chain.temperature);
+        writer.put<int32_t>(chain.noImprovementCount);
+        writer.put(previousSeconds + std::chrono::duration<double>(now - start).count());
+        writer.put(rng.getState());
+        writer.put(solution->getCost());
+        mutationOperation->saveState(writer);
+        std::shared_ptr<Solution> &snapshot = snapshots[nextSnapshot];
+        nextSnapshot ^= 1;
+        if constexpr (std::is_abstract_v<SolutionT>)
+        {
+            snapshot = solution->clone();
+        }
+        else if (!snapshot)
+        {
+            snapshot = std::make_shared<SolutionT>(*solution);
+        }
+        else
+        {
+            static_cast<SolutionT &>(*snapshot) = *solution;
+        }
+        checkpoints->submit([prefix = writer.release(), snapshot]()
+                            {
+                                CheckpointWriter payload(prefix);
+                                snapshot->saveState(payload);
+                                return payload.release(); });
+        checkpointTimer.done(now);
+    }
+
+    void report(long long iteration)
+    {
+        if (progress)
+        {
+            progress->record(0, iteration, bestCost);
+        }
+        if (timeToTarget < 0 && bestCost <= targetCost)
+        {
+            timeToTarget = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+    }
+
+    SolutionT *solution;                  // Текущее решение
+    MutationT *mutationOperation;         // Операция мутации решения
+    const CoolingT *coolingSchedule;      // План понижения температуры
+    double initialTemperature;            // Начальная температура каждой цепочки
+    int maxIterations;                    // Максимальное количество итераций цепочки
+    int maxNoImprovementCount;            // Условие останова или максимально число иттераций без улучшений
+    Xoshiro256 rng;                       // Генератор цепочки: используется и для мутаций, и для правила Метрополиса
+    double bestCost = 0;                  // Стоимость лучшего найденного решения
+    long long totalIterations = 0;        // Итерации всех завершенных цепочек
+    int chains = 0;                       // Количество выполненных цепочек
+    bool timeLimited = false;
+    Clock::time_point deadline;
+    ProgressSink *progress = nullptr;
+    double targetCost = -std::numeric_limits<double>::infinity();
+    Clock::time_point start;
+    double seconds = 0;
+    double timeToTarget = -1;
+    CheckpointSink *checkpoints = nullptr; // Приемник контрольных точек (может отсутствовать)
+    CheckpointTimer checkpointTimer;
+    bool resumed = false;                  // run продолжает цепочку resumedChain
+    ChainState resumedChain{};
+    double previousSeconds = 0; // Время работы до контрольной точки
+    std::shared_ptr<Solution> snapshots[2]; // Буферы снимков решения для потока записи
+    int nextSnapshot = 0;                   // Буфер следующего снимка
+};
+
+#endif // SIMULATED_ANNEALING_H
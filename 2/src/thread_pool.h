@@ -0,0 +1,228 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+// Пул потоков с очередью на каждый поток и кражей задач.
+// Задача, отправленная из рабочего потока, попадает в его собственную очередь и, скорее всего,
+// выполнится на нем же с теплым кэшем; простаивающие потоки забирают задачи из чужих очередей.
+// Потоки создаются один раз. По запросу (pinThreads) поток i закрепляется за i-м по счету ядром
+// из маски процесса (sched_getaffinity), так что ограничения taskset и cgroup соблюдаются. Закрепление
+// не делается по умолчанию: два пула в одном процессе или в соседних процессах с одной маской
+// закрепили бы свои потоки за одними и теми же ядрами
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int numThreads, bool pinThreads = false)
+        : queues(numThreads)
+    {
+        std::vector<int> cores;
+        if (pinThreads)
+        {
+            cores = allowedCores();
+        }
+        for (int i = 0; i < numThreads; ++i)
+        {
+            workers.emplace_back([this, i]()
+                                 { workerLoop(i); });
+            if (pinThreads)
+            {
+                pinToCore(workers.back(), i, cores);
+            }
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    // Сообщение о неудавшемся закреплении потоков (пусто, если закрепление не запрашивалось или удалось)
+    const std::string &getPinningError() const { return pinningError; }
+
+    // Номер рабочего потока пула, в котором выполняется вызов, или -1 вне пула
+    static int currentWorker() { return workerIndex; }
+
+    // Постановка задачи без результата
+    void post(std::function<void()> task)
+    {
+        int target = workerIndex >= 0 && workerOwner == this ? workerIndex : static_cast<int>(nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+        pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(queues[target].mutex);
+            queues[target].tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued++;
+        }
+        wakeUp.notify_one();
+    }
+
+    // Постановка задачи с результатом
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function &&function)
+    {
+        using Result = std::invoke_result_t<Function>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        std::future<Result> result = task->get_future();
+        post([task]()
+             { (*task)(); });
+        return result;
+    }
+
+    // Ожидание, пока не будут выполнены все поставленные задачи, включая порожденные ими
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        idle.wait(lock, [this]()
+                  { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+private:
+    // Очередь потока на отдельной строке кэша
+    struct alignas(64) WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // Ядра, на которых процессу разрешено выполняться
+    std::vector<int> allowedCores()
+    {
+        std::vector<int> cores;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        {
+            pinningError = "Unable to read the process CPU affinity mask, threads are not pinned";
+            return cores;
+        }
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                cores.push_back(cpu);
+            }
+        }
+        return cores;
+    }
+
+    // Потоков больше, чем ядер в маске, - ядра используются по кругу
+    void pinToCore(std::thread &thread, int index, const std::vector<int> &cores)
+    {
+        if (cores.empty())
+        {
+            return;
+        }
+        int core = cores[index % cores.size()];
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        int result = pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+        if (result != 0 && pinningError.empty())
+        {
+            pinningError = "Unable to pin worker " + std::to_string(index) + " to core " + std::to_string(core) + ": error " + std::to_string(result);
+        }
+    }
+
+    // Своя очередь берется с конца (LIFO, теплый кэш), чужие - с начала
+    bool takeTask(int self, std::function<void()> &task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if (!queues[self].tasks.empty())
+            {
+                task = std::move(queues[self].tasks.back());
+                queues[self].tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); ++k)
+        {
+            WorkQueue &victim = queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int self)
+    {
+        workerIndex = self;
+        workerOwner = this;
+        std::function<void()> task;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                wakeUp.wait(lock, [this]()
+                            { return stopping || queued > 0; });
+                if (queued == 0)
+                {
+                    return;
+                }
+                queued--;
+            }
+            // Счетчик queued гарантирует, что задача для этого потока где-то лежит
+            while (!takeTask(self, task))
+            {
+                std::this_thread::yield();
+            }
+            task();
+            task = nullptr;
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                idle.notify_all();
+            }
+        }
+    }
+
+    std::vector<WorkQueue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextQueue{0};
+    std::atomic<int> pending{0}; // Поставленные, но еще не завершенные задачи
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::condition_variable idle;
+    int queued = 0; // Задачи в очередях, еще не взятые потоками (под sleepMutex)
+    bool stopping = false;
+    std::string pinningError;
+
+    static inline thread_local int workerIndex = -1;
+    static inline thread_local ThreadPool *workerOwner = nullptr;
+};
+
+#endif // THREAD_POOL_H